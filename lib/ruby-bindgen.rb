@@ -10,6 +10,8 @@ require 'ruby-bindgen/namer'
 require 'ruby-bindgen/symbol_entry'
 require 'ruby-bindgen/symbol_candidates'
 require 'ruby-bindgen/symbols'
+require 'ruby-bindgen/extension_modules'
+require 'ruby-bindgen/trace_report'
 
 require 'ruby-bindgen/generators/generator'
 require 'ruby-bindgen/generators/cmake/cmake'
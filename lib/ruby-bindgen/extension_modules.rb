@@ -0,0 +1,130 @@
+require 'set'
+
+module RubyBindgen
+  # Splits a project into independently loadable sub-extensions, read from
+  # the `modules:` config shared by the Rice and CMake generators:
+  #
+  #   modules:
+  #     core:
+  #       paths: [opencv2/core]
+  #     dnn:
+  #       paths: [opencv2/dnn]
+  #       depends: [core]
+  #
+  # Each path is a directory prefix or a glob matched against a file's path
+  # relative to the input directory (headers for Rice, generated sources for
+  # CMake). Paths and patterns are compared without their extension, and
+  # generated sources without their `-rb` suffix, so `opencv2/core.hpp` and
+  # `guards/cuda*.hpp` select the header for Rice and the `-rb.cpp` file
+  # generated from it for CMake. Files that match no module stay in the main
+  # extension.
+  class ExtensionModules
+    ExtensionModule = Data.define(:name, :paths, :depends)
+
+    SOURCE_EXTENSION = /\.(?:h|hh|hpp|hxx|ipp|c|cc|cpp|cxx)\z/
+
+    # Modules in dependency order, dependencies first.
+    attr_reader :modules
+
+    def initialize(config = {})
+      config ||= {}
+      raise ArgumentError, "modules must be a mapping of module name to settings" unless config.is_a?(Hash)
+
+      declared = config.map do |name, settings|
+        settings ||= {}
+        name = name.to_s
+        raise ArgumentError, "module name must be a valid C/C++ identifier, got: #{name}" unless name.match?(/\A[A-Za-z_]\w*\z/)
+        ExtensionModule.new(name: name,
+                            paths: Array(settings[:paths]).map { |path| self.class.stem(path.to_s.chomp("/")) },
+                            depends: Array(settings[:depends]).map(&:to_s))
+      end
+
+      by_name = declared.to_h { |extension_module| [extension_module.name, extension_module] }
+      declared.each do |extension_module|
+        unknown = extension_module.depends.reject { |name| by_name.key?(name) }
+        raise ArgumentError, "module #{extension_module.name} depends on unknown module(s): #{unknown.join(', ')}" unless unknown.empty?
+      end
+
+      @modules = sort(declared, by_name)
+      @by_name = by_name
+    end
+
+    def empty?
+      @modules.empty?
+    end
+
+    # Name of the module that owns relative_path, a header or a generated
+    # source, or nil for the main extension. The first declared module with a
+    # matching path wins.
+    def module_for(relative_path)
+      path = self.class.stem(relative_path.to_s)
+      extension_module = @by_name.values.find do |candidate|
+        candidate.paths.any? { |pattern| path_match?(pattern, path) }
+      end
+      extension_module&.name
+    end
+
+    # inputs, [path, relative_path] pairs, with each module's files after the
+    # files of the modules it depends on and main extension files last, the
+    # order their Init functions run in. Files of one module keep their order.
+    def load_order(inputs)
+      ranks = @modules.each_with_index.to_h { |extension_module, index| [extension_module.name, index] }
+      inputs.each_with_index
+            .sort_by { |(_, relative_path), index| [ranks.fetch(module_for(relative_path), ranks.size), index] }
+            .map(&:first)
+    end
+
+    # A path without its extension and without the `-rb` suffix of generated
+    # sources: opencv2/core.hpp and opencv2/core-rb.cpp are both opencv2/core.
+    def self.stem(path)
+      path.sub(SOURCE_EXTENSION, "").delete_suffix("-rb")
+    end
+
+    # Names of every module name depends on, directly or indirectly. The main
+    # extension (nil) loads all modules first, so every module is available to it.
+    def dependencies(name)
+      return Set.new(@by_name.keys) if name.nil?
+
+      result = Set.new
+      pending = @by_name.fetch(name).depends.dup
+      until pending.empty?
+        dependency = pending.shift
+        next unless result.add?(dependency)
+        pending.concat(@by_name.fetch(dependency).depends)
+      end
+      result
+    end
+
+    private
+
+    def path_match?(pattern, path)
+      path == pattern ||
+        path.start_with?("#{pattern}/") ||
+        File.fnmatch?(pattern, path, File::FNM_PATHNAME)
+    end
+
+    # Depth-first topological sort that keeps declaration order where
+    # dependencies allow it.
+    def sort(declared, by_name)
+      sorted = []
+      state = {}
+      visit = lambda do |extension_module, chain|
+        case state[extension_module.name]
+        when :done
+          return
+        when :visiting
+          raise ArgumentError, "module dependency cycle: #{(chain + [extension_module.name]).join(' -> ')}"
+        end
+
+        state[extension_module.name] = :visiting
+        extension_module.depends.each do |dependency|
+          visit.call(by_name[dependency], chain + [extension_module.name])
+        end
+        state[extension_module.name] = :done
+        sorted << extension_module
+      end
+      declared.each { |extension_module| visit.call(extension_module, []) }
+      sorted
+    end
+  end
+end
@@ -1,3 +1,5 @@
+require 'json'
+
 module RubyBindgen
   module Generators
     class CMake < Generator
@@ -11,6 +13,72 @@ module RubyBindgen
         config[:include_dirs] || []
       end
 
+      def size_profile?
+        config[:size_profile] ? true : false
+      end
+
+      def time_trace?
+        config[:time_trace] ? true : false
+      end
+
+      # job_pools: config ({heavy:, threshold:}) or nil when not configured.
+      def job_pools
+        return nil unless config[:job_pools]
+
+        @job_pools ||= begin
+          pools = config[:job_pools]
+          heavy = Integer(pools[:heavy] || 2)
+          threshold = Integer(pools[:threshold] || 1000)
+          raise ArgumentError, "job_pools.heavy must be at least 1, got: #{heavy}" if heavy < 1
+          { heavy: heavy, threshold: threshold }
+        end
+      end
+
+      # Estimated compile weight of each generated source, keyed by path
+      # relative to the input directory. Read from the manifest the Rice
+      # generator writes with `manifest: true`.
+      def source_weights
+        @source_weights ||= begin
+          manifest_path = File.join(@inputter.base_path, Rice::MANIFEST)
+          unless File.exist?(manifest_path)
+            raise ArgumentError, "job_pools requires #{Rice::MANIFEST}; generate the Rice bindings with manifest: true first"
+          end
+
+          manifest = JSON.parse(File.read(manifest_path))
+          manifest.fetch("files").transform_values do |entry|
+            entry.values_at("classes", "methods", "constants", "instantiations").sum { |count| count.to_i }
+          end
+        end
+      end
+
+      # Whether a generated source should compile in the heavy job pool.
+      def heavy?(file)
+        return false unless job_pools
+
+        weight = source_weights[relative_source_path(file)]
+        !weight.nil? && weight >= job_pools[:threshold]
+      end
+
+      def extension_modules
+        @extension_modules ||= RubyBindgen::ExtensionModules.new(config[:modules])
+      end
+
+      # CMake target a generated source file is compiled into. Files owned by a
+      # module (including the module's own `{project}_{module}-rb.cpp`) go to
+      # that module's target, everything else to the main extension.
+      def target_for(file)
+        relative = relative_source_path(file)
+        extension_module = extension_modules.modules.find do |candidate|
+          relative == "#{project}_#{candidate.name}-rb.cpp"
+        end
+        name = extension_module&.name || extension_modules.module_for(relative)
+        name ? "${CMAKE_PROJECT_NAME}_#{name}" : "${CMAKE_PROJECT_NAME}"
+      end
+
+      def relative_source_path(file)
+        Pathname.new(expand_path(file)).relative_path_from(Pathname.new(File.expand_path(@inputter.base_path))).to_s
+      end
+
       def guards
         @guards ||= begin
           config_guards = config[:guards] || {}
@@ -57,6 +125,8 @@ module RubyBindgen
 
         file_guards, directory_guards = build_guard_maps(files_by_dir, all_dirs.to_a)
 
+        raise ArgumentError, "modules requires project" if !extension_modules.empty? && !@project
+
         if @project
           # Root CMakeLists.txt
           content = render_template("project",
@@ -68,12 +138,24 @@ module RubyBindgen
                                                                         files_by_dir["."].sort,
                                                                         file_guards,
                                                                         base),
-                                    :include_dirs => self.include_dirs)
+                                    :include_dirs => self.include_dirs,
+                                    :modules => extension_modules.modules,
+                                    :size_profile => size_profile?,
+                                    :job_pools => job_pools)
           self.outputter.write("CMakeLists.txt", content)
 
           # Presets
-          content = render_template("presets")
+          content = render_template("presets",
+                                    :size_profile => size_profile?,
+                                    :time_trace => time_trace?)
           self.outputter.write("CMakePresets.json", content)
+
+          # Linker version script for the size profile. Sub-extensions share
+          # Rice's registry through exported symbols, so there is none with modules.
+          if size_profile? && extension_modules.empty?
+            content = render_template("version_script", :project => self.project)
+            self.outputter.write("#{self.project}.map", content)
+          end
         end
 
         # Subdirectory CMakeLists.txt files
@@ -3,6 +3,21 @@ module RubyBindgen
     class FFI < Generator
       attr_reader :library_names, :library_versions
 
+      # FFI::Pointer array accessor suffix for each numeric element kind, as
+      # in put_array_of_float. char arrays are strings, and bool and long
+      # double have no packed accessors.
+      ARRAY_VIEW_TYPES = {
+        :type_float => "float", :type_double => "double",
+        :type_schar => "int8", :type_uchar => "uchar", :type_char_u => "uchar",
+        :type_short => "short", :type_ushort => "ushort",
+        :type_int => "int", :type_uint => "uint",
+        :type_long => "long", :type_ulong => "ulong",
+        :type_longlong => "long_long", :type_ulonglong => "ulong_long"
+      }.freeze
+
+      # FFI::Pointer get_/put_ suffix for each scalar field kind.
+      FIELD_ACCESSOR_TYPES = ARRAY_VIEW_TYPES.merge(:type_char_s => "char").freeze
+
       def self.template_dir
         __dir__
       end
@@ -18,6 +33,9 @@ module RubyBindgen
         @library_search_path = config[:library_search_path]
         @export_macros = config[:export_macros] || []
         @module_name = config[:module]
+        @array_views = config[:array_views] ? true : false
+        @lazy_attach = config[:lazy_attach] ? true : false
+        @field_accessors = config[:field_accessors] ? true : false
       end
 
       def generate
@@ -225,7 +243,8 @@ module RubyBindgen
 
         signature = @symbols.override(cursor)
         if signature
-          return self.render_cursor(cursor, "function", :parameter_types => nil, :signature => signature)
+          return self.render_cursor(cursor, "function", :parameter_types => nil, :signature => signature,
+                                    :blocking => @symbols.flag?(cursor, :blocking))
         end
 
         result = Array.new
@@ -243,7 +262,8 @@ module RubyBindgen
           end
         end
         parameter_types << ":varargs" if cursor.type.variadic?
-        result << self.render_cursor(cursor, "function", :parameter_types => parameter_types, :signature => nil)
+        result << self.render_cursor(cursor, "function", :parameter_types => parameter_types, :signature => nil,
+                                     :blocking => @symbols.flag?(cursor, :blocking))
         result.join("\n")
       end
 
@@ -611,6 +631,46 @@ module RubyBindgen
         end.join
       end
 
+      # Unversioned numeric fixed-size array fields of a struct, which
+      # array_views: true gives a reader returning the field's InlineArray
+      # and a bulk writer. Fields named like an FFI::Struct method keep only
+      # Struct#[].
+      def array_views(cursor)
+        return [] unless @array_views
+
+        cursor.find_by_kind(false, :cursor_field_decl).filter_map do |field|
+          next if field.ruby_name.empty? || @symbols.skip?(field) || @symbols.version(field)
+          next if ::FFI::Struct.method_defined?(field.ruby_name) || ::FFI::Struct.method_defined?("#{field.ruby_name}=")
+          next unless field.type.kind == :type_constant_array
+
+          accessor = ARRAY_VIEW_TYPES[field.type.element_type.canonical.kind]
+          { name: field.ruby_name, size: field.type.size, accessor: accessor } if accessor
+        end
+      end
+
+      # Scalar numeric fields of a struct without versioned fields, which
+      # field_accessors: true reads and writes at their layout offsets
+      # instead of through Struct#[]. The offsets come from offset_of when
+      # the bindings load, so they always match the layout FFI computed.
+      # Bitfields and fields named like an FFI::Struct method keep only
+      # Struct#[].
+      def field_accessors(cursor)
+        return [] unless @field_accessors
+
+        fields = cursor.find_by_kind(false, :cursor_field_decl)
+        return [] if fields.any? { |field| @symbols.version(field) }
+
+        fields.filter_map do |field|
+          next if field.ruby_name.empty? || field.bitfield? || @symbols.skip?(field)
+          next if ::FFI::Struct.method_defined?(field.ruby_name) || ::FFI::Struct.method_defined?("#{field.ruby_name}=")
+
+          accessor = FIELD_ACCESSOR_TYPES[field.type.canonical.kind]
+          next unless accessor
+
+          { name: field.ruby_name, offset: "#{field.ruby_name.upcase}_OFFSET", accessor: accessor }
+        end
+      end
+
       # Render a struct/union with versioned fields as separate definitions per version threshold.
       # Each version gets a complete definition with cumulative fields up to that version.
       # Output is wrapped in if/elsif/else guards.
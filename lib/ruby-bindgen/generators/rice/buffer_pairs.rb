@@ -0,0 +1,78 @@
+module RubyBindgen
+  module Generators
+    class Rice
+      # Finds pointer parameters that travel with their length or end pointer,
+      # so each pair can be bound as a single Ruby buffer argument:
+      #
+      #   void process(const float* data, size_t count);  // :length pair
+      #   void fill(int* begin, int* end);                 // :end pair
+      #
+      # Pointers to numeric types and void qualify. char and wchar_t pointers
+      # are strings and bool has no packed representation, so they do not.
+      #
+      # By default a pair is recognized by its parameter names. Callables
+      # listed under `symbols: buffer_pairs` are explicit, and pair any
+      # qualifying pointer with a following integral or same-typed pointer
+      # parameter whatever the names.
+      class BufferPairs
+        # Parameter indexes of the pointer and its partner. kind is :length
+        # or :end.
+        Pair = Struct.new(:pointer, :partner, :kind)
+
+        ELEMENT_KINDS = [:type_void, :type_uchar, :type_schar,
+                         :type_short, :type_ushort, :type_int, :type_uint,
+                         :type_long, :type_ulong, :type_longlong, :type_ulonglong,
+                         :type_float, :type_double].freeze
+
+        LENGTH_KINDS = [:type_short, :type_ushort, :type_int, :type_uint,
+                        :type_long, :type_ulong, :type_longlong, :type_ulonglong].freeze
+
+        # n, len, count, num_points, n_items, data_size, buffer_length, ...
+        LENGTH_NAME = /\A(?:n|cnt|num(?:_\w+)?|n_\w+|(?:\w+_)?(?:len|length|size|count|num))\z/
+        BEGIN_NAME = /\A(\w*?)_?(?:begin|first|start)\z/
+
+        def find(cursor, explicit: false)
+          types = cursor.type.arg_types
+          names = (0...cursor.num_arguments).map { |index| cursor.argument(index).spelling.underscore }
+
+          pairs = []
+          index = 0
+          while index < types.size - 1
+            pair = pair_at(types, names, index, explicit)
+            pairs << pair if pair
+            index += pair ? 2 : 1
+          end
+          pairs
+        end
+
+        private
+
+        def pair_at(types, names, index, explicit)
+          pointer = types[index].canonical
+          partner = types[index + 1].canonical
+          return nil unless element_pointer?(pointer)
+
+          if LENGTH_KINDS.include?(partner.kind)
+            Pair.new(index, index + 1, :length) if explicit || names[index + 1].match?(LENGTH_NAME)
+          elsif partner.spelling == pointer.spelling && pointer.pointee.canonical.kind != :type_void
+            Pair.new(index, index + 1, :end) if explicit || begin_end?(names[index], names[index + 1])
+          end
+        end
+
+        def element_pointer?(type)
+          type.kind == :type_pointer && ELEMENT_KINDS.include?(type.pointee.canonical.kind)
+        end
+
+        # begin/end, first/last, start/stop and prefixed forms such as
+        # src_begin/src_end.
+        def begin_end?(first, second)
+          match = BEGIN_NAME.match(first)
+          return false unless match
+
+          prefix = Regexp.escape(match[1])
+          second.match?(/\A#{prefix}_?(?:end|last|stop)\z/)
+        end
+      end
+    end
+  end
+end
@@ -15,7 +15,9 @@ module RubyBindgen
       #     iterator type.
       #
       # `record(cursor)` is the single entry point per iterator method.
-      # `clear` resets between translation units.
+      # `bulk_value_type` picks out iterators whose elements can be copied
+      # into a Ruby Array or packed String in one native loop
+      # (`bulk_iterators: true`). `clear` resets between translation units.
       class IteratorCollector
         # Inferred traits for one custom iterator. The hash key under which
         # this is stored is the iterator's qualified name; we don't repeat
@@ -62,8 +64,40 @@ module RubyBindgen
           names.include?("each_const") && !names.include?("each")
         end
   
+        # The value type of a random access iterator over a fundamental or
+        # POD type, or nil. Pointers count as random access iterators; class
+        # iterators must declare a random access or contiguous
+        # iterator_category.
+        def bulk_value_type(iterator_type)
+          canonical = iterator_type.canonical
+          value_type = if canonical.kind == :type_pointer
+                         canonical.pointee
+                       elsif canonical.kind == :type_record && random_access?(canonical.declaration)
+                         infer_value_type(canonical.declaration)
+                       end
+          return nil unless value_type
+
+          kind = value_type.canonical.kind
+          return value_type if kind == :type_record && value_type.canonical.pod?
+          return value_type if FUNDAMENTAL_TYPES.include?(kind) && ![:type_void, :type_nullptr].include?(kind)
+          nil
+        end
+
         private
   
+        RANDOM_ACCESS_CATEGORY = /\bstd::(?:__\w+::)?(?:random_access|contiguous)_iterator_tag\b/
+        private_constant :RANDOM_ACCESS_CATEGORY
+
+        def random_access?(decl)
+          decl.each do |child, _|
+            next unless child.kind == :cursor_type_alias_decl ||
+                        child.kind == :cursor_typedef_decl
+            next unless child.spelling == "iterator_category"
+            return child.underlying_type.canonical.spelling.match?(RANDOM_ACCESS_CATEGORY)
+          end
+          false
+        end
+
         def ruby_iterator_name(cursor)
           case cursor.spelling
           when "begin"  then cursor.const? ? "each_const"         : "each"
@@ -0,0 +1,90 @@
+require 'set'
+
+module RubyBindgen
+  module Generators
+    class Rice
+      # Maps each function and method name to its overload set, built once
+      # per scope instead of rescanning the siblings of every callable.
+      #
+      # A class scope is its own children. A namespace can be reopened, so a
+      # namespace scope collects every block of that namespace (and its
+      # `extern "C"` blocks) in the translation unit, found by USR. Function
+      # templates and using-declarations with the same spelling count as
+      # overloads, since both make `&Scope::name` ambiguous. Redeclarations
+      # of one function share a USR and count once.
+      #
+      # `clear` resets between translation units.
+      class OverloadIndex
+        SCOPE_KINDS = [:cursor_namespace, :cursor_linkage_spec].freeze
+        DECLARATION_KINDS = [:cursor_function, :cursor_function_template, :cursor_cxx_method,
+                             :cursor_conversion_function, :cursor_using_declaration].freeze
+
+        def initialize
+          @scopes = {}
+        end
+
+        def clear
+          @scopes.clear
+        end
+
+        # Number of declarations named like cursor in cursor's scope.
+        def count(cursor)
+          parent = cursor.semantic_parent
+          return 1 unless parent
+
+          declarations = scope(parent)[cursor.spelling]
+          declarations ? declarations.size : 1
+        end
+
+        def overloaded?(cursor)
+          count(cursor) > 1
+        end
+
+        private
+
+        def scope(parent)
+          key = scope_key(parent)
+          @scopes[[parent.kind, key]] ||= begin
+            names = Hash.new { |hash, name| hash[name] = Set.new }
+            if parent.kind == :cursor_translation_unit
+              collect(parent, names)
+              collect_namespace(parent, key, names, "")
+            elsif parent.kind == :cursor_namespace
+              collect_namespace(parent.translation_unit.cursor, key, names, "")
+            end
+            # Classes, and namespaces the walk cannot reach by USR.
+            collect(parent, names) if names.empty?
+            names
+          end
+        end
+
+        def scope_key(parent)
+          parent.kind == :cursor_translation_unit ? "" : parent.usr
+        end
+
+        # Walk the namespace and linkage blocks on the path to the scope
+        # identified by key, collecting the blocks that belong to it.
+        def collect_namespace(cursor, key, names, current)
+          cursor.each(false) do |child, _|
+            next unless SCOPE_KINDS.include?(child.kind)
+
+            child_key = child.kind == :cursor_namespace ? child.usr : current
+            collect(child, names) if child_key == key
+            if child_key == current || child_key == key || key.start_with?("#{child_key}@")
+              collect_namespace(child, key, names, child_key)
+            end
+          end
+        end
+
+        def collect(cursor, names)
+          cursor.each(false) do |child, _|
+            next unless DECLARATION_KINDS.include?(child.kind)
+
+            identity = child.kind == :cursor_using_declaration ? [child.spelling, child.location.to_s] : child.usr
+            names[child.spelling] << identity
+          end
+        end
+      end
+    end
+  end
+end
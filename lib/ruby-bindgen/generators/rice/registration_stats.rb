@@ -0,0 +1,67 @@
+module RubyBindgen
+  module Generators
+    class Rice
+      # Counts the classes, methods and constants a translation unit's
+      # generated code registers, plus the class template builders it calls.
+      # Used by the `profile_init: true` report and the `manifest: true`
+      # file that the CMake generator reads to find heavy sources.
+      #
+      # Counts are taken from the templates rendered while generating the
+      # translation unit, so they describe the emitted code: members of a
+      # class template are counted once in the file that defines the
+      # template's builder, and version guarded members are always counted.
+      class RegistrationStats
+        CATEGORIES = {
+          "auto_generated_base_class" => :classes,
+          "class" => :classes,
+          "class_template_specialization" => :classes,
+          "enum_decl" => :classes,
+          "incomplete_class" => :classes,
+          "union" => :classes,
+          "array_view" => :methods,
+          "buffer_pair_callable" => :methods,
+          "constructor" => :methods,
+          "conversion_function" => :methods,
+          "cxx_iterator_method" => :methods,
+          "cxx_method" => :methods,
+          "fast_path_function" => :methods,
+          "field_decl" => :methods,
+          "field_reference" => :methods,
+          "function" => :methods,
+          "iterator_bulk_methods" => :methods,
+          "non_member_operator_binary" => :methods,
+          "non_member_operator_inspect" => :methods,
+          "non_member_operator_unary" => :methods,
+          "operator[]" => :methods,
+          "variable" => :methods,
+          "vectorized_callable" => :methods,
+          "constant" => :constants,
+          "enum_constant_decl" => :constants
+        }.freeze
+
+        # Templates that call a class template `_instantiate` builder.
+        INSTANTIATIONS = %w[auto_generated_base_class class_template_specialization].freeze
+
+        def initialize
+          clear
+        end
+
+        def clear
+          @counts = { classes: 0, methods: 0, constants: 0, instantiations: 0 }
+        end
+
+        # Count one rendered template. Templates that register nothing
+        # (translation units, namespaces, ...) are ignored.
+        def record(template)
+          category = CATEGORIES[template]
+          @counts[category] += 1 if category
+          @counts[:instantiations] += 1 if INSTANTIATIONS.include?(template)
+        end
+
+        def to_h
+          @counts.dup
+        end
+      end
+    end
+  end
+end
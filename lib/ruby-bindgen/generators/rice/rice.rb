@@ -1,3 +1,4 @@
+require 'json'
 require 'set'
 
 # Forward declaration so the helper files below can nest their classes
@@ -10,10 +11,15 @@ module RubyBindgen
   end
 end
 
+require_relative 'buffer_pairs'
 require_relative 'function_pointer'
 require_relative 'iterator_collector'
+require_relative 'overload_index'
 require_relative 'reference_qualifier'
+require_relative 'registration_stats'
 require_relative 'signature_builder'
+require_relative 'stl_collector'
+require_relative 'template_instantiations'
 require_relative 'template_resolver'
 require_relative 'type_index'
 require_relative 'type_speller'
@@ -151,6 +157,9 @@ module RubyBindgen
         :type_nullptr
       ].freeze
 
+      # File name of the manifest written with `manifest: true`.
+      MANIFEST = "ruby-bindgen-manifest.json".freeze
+
       # Directory containing the ERB templates used by the Rice generator.
       def self.template_dir
         __dir__
@@ -172,6 +181,37 @@ module RubyBindgen
         @export_macros = config[:export_macros] || []
         @version_check = config[:version_check]
         raise ArgumentError, "version_check is required when symbols.versions is non-empty" if @symbols.has_versions? && !@version_check
+        @stl_headers = (config[:stl_headers] || "all").to_s
+        raise ArgumentError, "stl_headers must be 'all' or 'minimal', got: #{@stl_headers}" unless %w[all minimal].include?(@stl_headers)
+        @extern_templates = config[:extern_templates] ? true : false
+        @lazy = config[:lazy] ? true : false
+        @cold_init = config[:cold_init] ? true : false
+        @modules = RubyBindgen::ExtensionModules.new(config[:modules])
+        raise ArgumentError, "modules requires project" if !@modules.empty? && !@project
+        @init_modules = Hash.new  # Maps rice_header -> owning module name (nil for the main extension)
+        @profile_init = config[:profile_init] ? true : false
+        @bulk_iterators = config[:bulk_iterators] ? true : false
+        @field_references = config[:field_references] ? true : false
+        @array_views = config[:array_views] ? true : false
+        @ractor_safe = config[:ractor_safe] ? true : false
+        raise ArgumentError, "ractor_safe requires project" if @ractor_safe && !@project
+        raise ArgumentError, "ractor_safe cannot be combined with lazy" if @ractor_safe && @lazy
+        @registration_stats = RegistrationStats.new
+        @init_stats = Hash.new  # Maps rice_header -> classes/methods/constants counts for profile_init
+        @manifest = config[:manifest] ? true : false
+        @manifest_entries = Hash.new  # Maps rice_cpp -> manifest entry
+        @signatures = (config[:signatures] || "all").to_s
+        raise ArgumentError, "signatures must be 'all' or 'overloaded', got: #{@signatures}" unless %w[all overloaded].include?(@signatures)
+        @overload_index = OverloadIndex.new
+        @disambiguated_names = Set.new  # [scope USR, Ruby name] pairs bound for disambiguate_overloads
+        @native_functions = []  # Ruby C API functions for fast_path symbols and memory_view classes
+        @memory_views = memory_view_config(config[:memory_view])  # Maps C++ class name -> accessor expressions
+        @memory_views_found = Set.new
+        @buffer_pairs = config[:buffer_pairs] ? true : false
+        @buffer_pair_finder = BufferPairs.new
+        # Whether generated files include the BufferView header
+        @buffer_views = @buffer_pairs || @array_views || [:buffer_pairs, :vectorize].any? { |flag| !Array((config[:symbols] || {})[flag]).empty? }
+        @fast_path_registrations = Hash.new { |h, k| h[k] = Hash.new { |versions, version| versions[version] = [] } }
 
         # Build naming tables: merge operator defaults with user config
         symbols_config = config[:symbols] || {}
@@ -189,13 +229,20 @@ module RubyBindgen
         # Non-member operators grouped by target class cruby_name
         @non_member_operators = Hash.new { |h, k| h[k] = [] }
         @iterator_collector = IteratorCollector.new
+        @stl_collector = StlCollector.new
+        @template_instantiations = TemplateInstantiations.new
+        @extern_instantiations = Set.new
+        @specialization_owners = Hash.new { |h, k| h[k] = Hash.new }  # Maps specialization spelling -> module -> init name of the registering file
       end
 
       # Parse the configured inputs with libclang and stream the resulting
-      # translation units back through this visitor.
+      # translation units back through this visitor. With modules, files are
+      # processed in load order so claim_specialization picks an owner that
+      # every other user loads first.
       def generate
         clang_args = @config[:clang_args] || []
-        parser = RubyBindgen::Parser.new(@inputter, clang_args, libclang: @config[:libclang])
+        inputs = @modules.empty? ? @inputter : @modules.load_order(@inputter)
+        parser = RubyBindgen::Parser.new(inputs, clang_args, libclang: @config[:libclang])
         ::FFI::Clang::Cursor.namer = @namer
         parser.generate(self)
       end
@@ -384,6 +431,9 @@ module RubyBindgen
       def visit_start
         # Clear caches from previous runs
         @type_speller.clear
+        @stl_collector.clear
+        @template_instantiations.clear
+        @specialization_owners.clear
       end
 
       def visit_parse_error(_path, relative_path, error)
@@ -395,7 +445,12 @@ module RubyBindgen
       # translation units have been processed.
       def visit_end
         create_rice_include_header
+        create_lazy_init_header
+        create_memory_view_header
+        create_buffer_view_header
+        create_template_instantiation_files
         create_project_files
+        create_manifest
       end
 
       # Returns the path to the Rice include header (user-specified or auto-generated)
@@ -403,6 +458,19 @@ module RubyBindgen
         @include_header || "#{@project || 'rice'}_include.hpp"
       end
 
+      # Returns the path to the support header used by lazy: true
+      def lazy_init_header
+        "#{@project || 'rice'}_lazy_init.hpp"
+      end
+
+      def memory_view_header
+        "#{@project || 'rice'}_memory_view.hpp"
+      end
+
+      def buffer_view_header
+        "#{@project || 'rice'}_buffer_view.hpp"
+      end
+
       # Compute the .ipp path for a template defined in a different file.
       def ipp_path_for_cursor(cursor)
         template_file = cursor.file_location.file
@@ -412,6 +480,8 @@ module RubyBindgen
 
       # Generate default Rice include header if user didn't specify one.
       # If the file already exists on disk, preserve it so user customizations are not lost.
+      # With `stl_headers: minimal` the header lists the Rice STL headers for the
+      # std:: types the bindings use, so it must be deleted to pick up new types.
       def create_rice_include_header
         return if @include_header  # User specified their own header
 
@@ -423,10 +493,161 @@ module RubyBindgen
         end
 
         STDOUT << "  Writing: " << header_path << "\n"
-        content = render_template("rice_include.hpp")
+        stl_headers = @stl_headers == "minimal" ? @stl_collector.headers : nil
+        content = render_template("rice_include.hpp", :stl_headers => stl_headers)
         self.outputter.write(header_path, content)
       end
 
+      # With lazy: true, write the RubyBindgen::LazyInit support header the
+      # generated translation units include. It is generated code rather than a
+      # customization point, so it is rewritten on every run.
+      def create_lazy_init_header
+        return unless @lazy
+
+        STDOUT << "  Writing: " << lazy_init_header << "\n"
+        self.outputter.write(lazy_init_header, render_template("lazy_init.hpp"))
+      end
+
+      def create_memory_view_header
+        return if @memory_views.empty?
+
+        (@memory_views.keys - @memory_views_found.to_a).each do |name|
+          warn "Warning: memory_view class not found: #{name}"
+        end
+
+        STDOUT << "  Writing: " << memory_view_header << "\n"
+        self.outputter.write(memory_view_header, render_template("memory_view.hpp"))
+      end
+
+      def create_buffer_view_header
+        return unless @buffer_views
+
+        STDOUT << "  Writing: " << buffer_view_header << "\n"
+        self.outputter.write(buffer_view_header, render_template("buffer_view.hpp"))
+      end
+
+      # With manifest: true, write a JSON description of every generated
+      # `-rb.cpp` file (owning header, Init function, registration counts and
+      # bound C++ types). The CMake generator uses it to find heavy sources.
+      def create_manifest
+        return unless @manifest
+
+        STDOUT << "  Writing: " << MANIFEST << "\n"
+        content = JSON.pretty_generate({ generator: "ruby-bindgen #{RubyBindgen::VERSION}",
+                                         files: @manifest_entries.sort.to_h })
+        self.outputter.write(MANIFEST, content + "\n")
+      end
+
+      # With extern_templates, write one file per `-rb.ipp` that explicitly
+      # instantiates every builder specialization the bindings call. The
+      # translation units calling them only see `extern template` declarations.
+      def create_template_instantiation_files
+        return unless @extern_templates
+
+        @template_instantiations.each_ipp do |ipp, instantiations, headers|
+          basename = File.basename(ipp, "-rb.ipp")
+          instantiations_cpp = File.join(File.dirname(ipp), "#{basename}_instantiations-rb.cpp")
+          STDOUT << "  Writing: " << instantiations_cpp << "\n"
+          content = render_template("template_instantiations.cpp",
+                                    :headers => headers,
+                                    :rice_header => "#{basename}-rb.hpp",
+                                    :rice_ipp => File.basename(ipp),
+                                    :instantiations => instantiations)
+          self.outputter.write(instantiations_cpp, content)
+        end
+      end
+
+      # Record a class template builder call. With extern_templates the current
+      # translation unit declares it extern and visit_end instantiates it once.
+      def record_instantiation(cursor_template, specialization, template_arguments, version)
+        return unless @extern_templates
+
+        template_owner = template_cursor_definition(cursor_template)
+        template_header = Pathname.new(template_owner.file_location.file)
+                                  .relative_path_from(Pathname.new(@inputter.base_path)).to_s
+        instantiation = TemplateInstantiations::Instantiation.new(builder: "#{cursor_template.spelling}_instantiate",
+                                                                  arguments: template_arguments,
+                                                                  specialization: specialization,
+                                                                  ipp: ipp_path_for_cursor(template_owner),
+                                                                  version: version)
+        @template_instantiations.add(instantiation, [template_header, @relative_path])
+        @extern_instantiations << instantiation
+      end
+
+      # Claim a class template specialization for the current translation unit.
+      # Only done for projects: the project Init function calls the per-file
+      # Init functions in generation order, and generate processes modules in
+      # dependency order with the main extension last, so the owning file
+      # always runs first. The owner must be in the same module or one it
+      # depends on, so each unrelated module records an owner of its own.
+      #
+      # Returns [status, owner]. status is :register when this file registers
+      # the specialization, :reference when owner always registers it first,
+      # or :fallback when owner only does so under a version guard that does
+      # not cover version, this use's guard. This file then registers it when
+      # the owner's guard is off (see fallback_guard).
+      def claim_specialization(specialization, version)
+        return [:register, nil] unless @project
+
+        owner = specialization_owner(specialization)
+        if owner.nil?
+          @specialization_owners[specialization.gsub(/\s+/, "")][@module] = { inits: [@init_name], version: version }
+          [:register, nil]
+        elsif owner[:inits].include?(@init_name)
+          [:register, owner]
+        elsif version_covers?(owner[:version], version)
+          [:reference, owner]
+        else
+          # Together the owner and this file register it from the lower of
+          # the two versions on
+          @specialization_owners[specialization.gsub(/\s+/, "")][@module] =
+            { inits: owner[:inits] + [@init_name], version: version && [owner[:version], version].min }
+          [:fallback, owner]
+        end
+      end
+
+      # The registration of specialization visible to the current file's
+      # module, { inits:, version: }, or nil when none is yet. Of several,
+      # the one with the widest version guard wins.
+      def specialization_owner(specialization)
+        owners = @specialization_owners[specialization.gsub(/\s+/, "")]
+        scope = [@module, *@modules.dependencies(@module)]
+        owners.values_at(*scope).compact.min_by { |owner| owner[:version] ? [1, owner[:version]] : [0, 0] }
+      end
+
+      # Whether code guarded by owner_version always runs when code guarded
+      # by version does. nil means unguarded.
+      def version_covers?(owner_version, version)
+        owner_version.nil? || (!version.nil? && version >= owner_version)
+      end
+
+      # Registers a specialization only when the guard of its owner, see
+      # claim_specialization, is off, and otherwise uses reference if given.
+      def fallback_guard(owner, registration, reference = nil)
+        lines = ["#if #{@version_check} < #{owner[:version]}", registration.chomp]
+        lines.push("#else", reference.chomp) if reference
+        lines << "#endif"
+        lines.join("\n") + "\n"
+      end
+
+      # The version guard around cursor's generated code: the highest version
+      # set on it or an enclosing class or namespace, or nil when unguarded.
+      def guard_version(cursor)
+        [cursor, *cursor.ancestors_by_kind(:cursor_class_decl, :cursor_struct, :cursor_namespace)]
+          .filter_map { |ancestor| @symbols.version(ancestor) }.max
+      end
+
+      # Render builder instantiations as `template ...;` lines (prefixed with
+      # `extern ` for declarations), grouped under their version guards.
+      def render_instantiations(instantiations, prefix)
+        versions = instantiations.group_by(&:version)
+        lines = versions.keys.sort_by(&:to_s).flat_map do |version|
+          declarations = versions[version].map { |instantiation| "#{prefix}#{instantiation.declaration}" }
+          version ? ["#if #{@version_check} >= #{version}", *declarations, "#endif"] : declarations
+        end
+        lines.join("\n")
+      end
+
       # Render one translation unit into its generated `-rb.hpp`, `-rb.cpp`, and
       # optional `-rb.ipp` outputs.
       def visit_translation_unit(translation_unit, path, relative_path)
@@ -435,6 +656,13 @@ module RubyBindgen
         @auto_generated_bases.clear
         @non_member_operators.clear
         @iterator_collector.clear
+        @extern_instantiations.clear
+        @registration_stats.clear
+        @overload_index.clear
+        @disambiguated_names.clear
+        @native_functions.clear
+        @fast_path_registrations.clear
+        @relative_path = relative_path
         cursor = translation_unit.cursor
         @translation_unit_cursor = cursor
         @type_speller.printing_policy = cursor.printing_policy
@@ -455,10 +683,25 @@ module RubyBindgen
         dir_part = path_parts.map(&:camelize).join('_')
         init_name = dir_part.empty? ? "Init_#{filename}" : "Init_#{dir_part}_#{filename}"
         @init_names[rice_header] = init_name
+        @init_name = init_name
+        @module = @modules.module_for(relative_path)
+        @init_modules[rice_header] = @module
 
         @includes = Set.new
         @includes << "#include <#{relative_path}>"
         @includes << "#include \"#{@basename}.hpp\""
+        if @lazy
+          relative_lazy_init = Pathname.new(lazy_init_header).relative_path_from(File.dirname(relative_path)).to_s
+          @includes << "#include \"#{relative_lazy_init}\""
+        end
+        unless @memory_views.empty?
+          relative_memory_view = Pathname.new(memory_view_header).relative_path_from(File.dirname(relative_path)).to_s
+          @includes << "#include \"#{relative_memory_view}\""
+        end
+        if @buffer_views
+          relative_buffer_view = Pathname.new(buffer_view_header).relative_path_from(File.dirname(relative_path)).to_s
+          @includes << "#include \"#{relative_buffer_view}\""
+        end
 
         class_templates, has_builders = render_class_templates(cursor)
         content = render_children(cursor, :indentation => 2)
@@ -479,6 +722,11 @@ module RubyBindgen
           self.outputter.write(rice_ipp, ipp_content)
         end
 
+        @init_stats[rice_header] = @registration_stats.to_h
+        @manifest_entries[Pathname.new(rice_cpp).cleanpath.to_s] = { header: relative_path, init: init_name }
+                                        .merge(@registration_stats.to_h)
+                                        .merge(types: @classes.values.uniq)
+
         # Render C++ file
         STDOUT << "  Writing: " << rice_cpp << "\n"
         content = render_cursor(cursor, "translation_unit.cpp",
@@ -488,6 +736,9 @@ module RubyBindgen
                                 :init_name => init_name,
                                 :rice_header => rice_header,
                                 :incomplete_iterators => @iterator_collector.incomplete_iterators,
+                                :extern_instantiations => @extern_instantiations.to_a,
+                                :cold_init => @cold_init,
+                                :native_functions => @native_functions,
                                 :rice_ipp => rice_ipp ? File.basename(rice_ipp) : nil)
         self.outputter.write(rice_cpp, content)
 
@@ -497,7 +748,8 @@ module RubyBindgen
         relative_include = Pathname.new(rice_include_header).relative_path_from(File.dirname(relative_path)).to_s
         content = render_cursor(cursor, "translation_unit.hpp",
                                 :init_name => init_name,
-                                :rice_include_header => relative_include)
+                                :rice_include_header => relative_include,
+                                :cold_init => @cold_init)
         self.outputter.write(rice_header, content)
       end
 
@@ -530,6 +782,8 @@ module RubyBindgen
 
         return unless signature
 
+        @stl_collector.record(cursor.type)
+
         self.render_cursor(cursor, "constructor",
                            :signature => signature, :args => args)
       end
@@ -559,10 +813,11 @@ module RubyBindgen
         if base_specifier
           # Use canonical spelling for fully qualified type name with namespaces
           base = base_specifier.type.canonical.spelling
+          @stl_collector.record(base_specifier.type)
 
           # Check if base is a template instantiation that needs to be auto-generated
           if base.include?('<') && !@auto_generated_bases.include?(base)
-            auto_generated_base = auto_generate_template_base_for_class(base_specifier, base, under)
+            auto_generated_base = auto_generate_template_base_for_class(base_specifier, base, under, guard_version(cursor))
           end
         end
 
@@ -622,17 +877,36 @@ module RubyBindgen
         ruby_class_name = @namer.apply_rename_types(raw_class_name, raw_class_name.camelize)
         has_incomplete_classes = !incomplete_classes_content.to_s.empty?
         @classes[cursor.cruby_name] = cpp_type
+
+        # Alias each_const to each if the class only has const iterators
+        iterator_alias = nil
+        if @iterator_collector.each_const_only?(cursor.cruby_name)
+          iterator_alias = render_template("iterator_alias", :cruby_name => cursor.cruby_name)
+        end
+
+        # With lazy: true members are registered on first use, so the alias
+        # has to be made by the same loader that defines each_const.
+        lazy = @lazy && children_content != ";"
         result[nil] << self.render_cursor(cursor, "class", :under => under, :base => base,
                                      :auto_generated_base => auto_generated_base,
                                      :incomplete_classes => incomplete_classes_content,
                                      :children => children_content,
                                      :cpp_type => cpp_type,
                                      :ruby_class_name => ruby_class_name,
-                                     :has_incomplete_classes => has_incomplete_classes)
+                                     :has_incomplete_classes => has_incomplete_classes,
+                                     :lazy => lazy,
+                                     :iterator_alias => lazy ? iterator_alias : nil)
+        result[nil] << iterator_alias if iterator_alias && !lazy
+
+        # fast_path methods are registered with the Ruby C API after the class
+        @fast_path_registrations.delete(cursor.cruby_name)&.each do |version, registrations|
+          result[version] << registrations.join("\n")
+        end
 
-        # Alias each_const to each if the class only has const iterators
-        if @iterator_collector.each_const_only?(cursor.cruby_name)
-          result[nil] << render_template("iterator_alias", :cruby_name => cursor.cruby_name)
+        # memory_view classes are registered as MemoryView providers after the class
+        if (view = @memory_views[cpp_type])
+          @memory_views_found << cpp_type
+          result[nil] << visit_memory_view(cursor, cpp_type, view)
         end
 
         # Define any complete embedded classes and structs
@@ -685,7 +959,7 @@ module RubyBindgen
             instantiated_type = @type_speller.qualify_class_static_members(instantiated_type, cursor)
             next if @type_index.typedef_for(instantiated_type)
 
-            code = auto_instantiate_template(decl, instantiated_type, instantiated_type_source, under)
+            code = auto_instantiate_template(decl, instantiated_type, instantiated_type_source, under, guard_version(cursor))
             result << code unless code.empty?
           end
         end
@@ -783,6 +1057,8 @@ module RubyBindgen
         result << self.render_cursor(cursor, "class_template", :under => under,
                                      :template_signature => template_signature,
                                      :fully_qualified_type => fully_qualified_type,
+                                     :extern_templates => @extern_templates,
+                                     :cold_init => @cold_init,
                                      :base_spelling => base_spelling,
                                      :children => children_content)
 
@@ -806,6 +1082,207 @@ module RubyBindgen
         @export_macros.any? { |macro| source_text.include?(macro) }
       end
 
+      # The explicit signature template argument for define_method and
+      # define_function. With `signatures: overloaded` it is only emitted when
+      # the name is overloaded; otherwise Rice deduces the type from the
+      # pointer, which saves the compiler from parsing a spelled out
+      # pointer-to-member type for every wrapper.
+      def callable_signature(cursor)
+        signature = @signature_builder.method_signature(cursor)
+        return signature if @signatures == "all" || signature.nil?
+
+        @overload_index.overloaded?(cursor) ? signature : nil
+      end
+
+      # Additional Ruby name for one overload of a `disambiguate_overloads`
+      # callable: its name followed by its parameter types, such as
+      # overloaded_int. Binding each overload under its own name lets hot
+      # call sites skip Rice's overload resolution, which tries every
+      # overload's argument conversions on each call. Returns nil when the
+      # callable is not listed or not overloaded.
+      def disambiguated_name(cursor)
+        return nil unless @symbols.flag?(cursor, :disambiguate_overloads)
+        return nil unless @overload_index.overloaded?(cursor)
+
+        unless cursor.ruby_name.match?(/\A\w+\z/)
+          warn "Warning: disambiguate_overloads ignored for #{cursor.qualified_name}: #{cursor.ruby_name} is not a plain method name"
+          return nil
+        end
+
+        suffixes = cursor.type.arg_types.map { |arg_type| overload_suffix(arg_type) }
+        name = "#{cursor.ruby_name}_#{suffixes.empty? ? "void" : suffixes.join("_")}"
+        unless @disambiguated_names.add?([cursor.semantic_parent.usr, name])
+          warn "Warning: disambiguate_overloads ignored for #{cursor.qualified_name}: another overload is already bound as #{name}"
+          return nil
+        end
+        name
+      end
+
+      # Name part for one parameter type: int, unsigned_int, string,
+      # mat_ptr, ...
+      def overload_suffix(type)
+        type = type.non_reference_type if type.reference?
+        return "#{overload_suffix(type.pointee)}_ptr" if type.kind == :type_pointer
+
+        decl = type.declaration
+        spelling = decl.kind == :cursor_no_decl_found ? type.canonical.spelling : decl.spelling
+        spelling.gsub(/\b(?:const|volatile)\b/, "").strip.underscore.gsub(/\W+/, "_")
+      end
+
+      # Whether a `no_gvl` method or function should release the GVL while it
+      # runs (Rice's NoGVL option). Code running without the GVL must not
+      # touch Ruby objects, so callables that take Ruby objects or callbacks
+      # into Ruby keep the GVL and print a warning.
+      def no_gvl?(cursor)
+        return false unless @symbols.flag?(cursor, :no_gvl)
+
+        unsafe = cursor.type.arg_types.each_with_index.find { |arg_type, _| ruby_object_type?(arg_type) }
+        if unsafe
+          arg_type, index = unsafe
+          warn "Warning: no_gvl ignored for #{cursor.qualified_name}: parameter #{index + 1} (#{arg_type.spelling}) " \
+               "can reach Ruby objects, which is unsafe without the GVL"
+          return false
+        end
+        true
+      end
+
+      # Pointer parameters to bind together with their length or end pointer,
+      # found by name with buffer_pairs: true or by type for callables listed
+      # under symbols: buffer_pairs. Pairs with default values are left alone.
+      def buffer_pairs(cursor, args)
+        explicit = @symbols.flag?(cursor, :buffer_pairs)
+        return [] unless explicit || @buffer_pairs
+
+        pairs = @buffer_pair_finder.find(cursor, explicit: explicit)
+                                   .reject { |pair| args[pair.pointer].include?("=") || args[pair.partner].include?("=") }
+        if pairs.empty?
+          warn "Warning: buffer_pairs ignored for #{cursor.qualified_name}: no pointer and length or begin and end parameters" if explicit
+        elsif @symbols.flag?(cursor, :no_gvl)
+          warn "Warning: buffer_pairs ignored for #{cursor.qualified_name}: reading Ruby buffers needs the GVL that no_gvl releases"
+          pairs = []
+        end
+        pairs
+      end
+
+      # C++ names for a callable's parameters inside a generated lambda.
+      # Unnamed parameters become arg_<index>. Names that could shadow the
+      # receiver or a generated local (self, <name>_view, rb_<name>_) get a
+      # trailing underscore. Ruby argument names are not affected.
+      def lambda_param_names(cursor)
+        (0...cursor.num_arguments).map do |index|
+          spelling = cursor.argument(index).spelling
+          if spelling.empty?
+            "arg_#{index}"
+          elsif spelling == "self" || spelling.end_with?("_view") || spelling.match?(/\Arb_\w*_\z/)
+            "#{spelling}_"
+          else
+            spelling
+          end
+        end
+      end
+
+      # Render a callable whose buffer pairs each take one Ruby String, Array
+      # or MemoryView, as a lambda that unpacks them with RubyBindgen::BufferView.
+      def render_buffer_pairs(cursor, pairs, args, definition, name, callee, self_param, return_buffer, terminate: false)
+        pointers = pairs.to_h { |pair| [pair.pointer, pair] }
+        partners = pairs.to_h { |pair| [pair.partner, pair] }
+        names = lambda_param_names(cursor)
+
+        params = self_param ? [self_param] : []
+        call_args = []
+        views = []
+        ruby_args = []
+        cursor.type.arg_types.each_with_index do |arg_type, index|
+          if (pair = partners[index])
+            view = "#{names[pair.pointer]}_view"
+            call_args << (pair.kind == :length ? "#{view}.length<#{@type_speller.type_spelling(arg_type)}>()" : "#{view}.data() + #{view}.size()")
+          elsif pointers[index]
+            params << "Rice::Object #{names[index]}"
+            call_args << "#{names[index]}_view.data()"
+            views << { type: @type_speller.type_spelling(arg_type.pointee), name: names[index],
+                       writable: !arg_type.pointee.const_qualified? }
+            ruby_args << args[index].sub(/\AArgBuffer\(/, "Arg(")
+          else
+            params << "#{@type_speller.type_spelling(arg_type)} #{names[index]}"
+            call_args << (arg_type.kind == :type_rvalue_ref ? "std::move(#{names[index]})" : names[index])
+            ruby_args << args[index]
+          end
+        end
+
+        render_cursor(cursor, "buffer_pair_callable",
+                      :definition => definition,
+                      :name => name,
+                      :params => params,
+                      :views => views,
+                      :callee => callee,
+                      :call_args => call_args,
+                      :returns_void => cursor.type.result_type.kind == :type_void,
+                      :args => ruby_args,
+                      :return_buffer => return_buffer,
+                      :terminate => terminate)
+      end
+
+      # Whether a vectorize callable takes and returns only numbers, so its
+      # `_many` variant can read each parameter from a packed buffer.
+      def vectorizable?(cursor)
+        reason = if @overload_index.overloaded?(cursor)
+                   "overloaded callables would share one `_many` name"
+                 elsif cursor.type.args_size == 0
+                   "there are no parameters to vectorize"
+                 elsif !cursor.type.arg_types.all? { |arg_type| vectorize_type?(arg_type, parameter: true) }
+                   "parameters must be numbers passed by value or const reference"
+                 elsif !(cursor.type.result_type.kind == :type_void || vectorize_type?(cursor.type.result_type))
+                   "the return type must be void or a number"
+                 end
+        warn "Warning: vectorize ignored for #{cursor.qualified_name}: #{reason}" if reason
+        reason.nil?
+      end
+
+      def vectorize_type?(type, parameter: false)
+        if parameter && type.kind == :type_lvalue_ref
+          type = type.non_reference_type
+          return false unless type.const_qualified?
+        end
+        kind = type.canonical.kind
+        kind != :type_void && BufferPairs::ELEMENT_KINDS.include?(kind)
+      end
+
+      # Render the `_many` variant of a vectorize callable. Each parameter is
+      # read from a packed String, Array or MemoryView, the callable runs once
+      # per element in C++, and results are returned as a packed String.
+      def render_vectorized(cursor, definition, callee, self_param, terminate: false)
+        names = lambda_param_names(cursor)
+        inputs = cursor.type.arg_types.each_with_index.map do |arg_type, index|
+          spelling = cursor.argument(index).spelling
+          { name: names[index],
+            arg: (spelling.empty? ? names[index] : spelling).underscore,
+            type: @type_speller.type_spelling(arg_type.non_reference_type.unqualified_type) }
+        end
+        result_type = cursor.type.result_type
+
+        render_cursor(cursor, "vectorized_callable",
+                      :definition => definition,
+                      :name => "#{cursor.ruby_name}_many",
+                      :params => (self_param ? [self_param] : []) + inputs.map { |input| "Rice::Object #{input[:name]}" },
+                      :inputs => inputs,
+                      :callee => callee,
+                      :return_type => result_type.kind == :type_void ? nil : @type_speller.type_spelling(result_type.unqualified_type),
+                      :terminate => terminate)
+      end
+
+      # VALUE, Rice wrapper objects, std::function and function pointer
+      # callbacks all let C++ code reach into the Ruby VM.
+      def ruby_object_type?(type)
+        type = type.non_reference_type while type.kind == :type_lvalue_ref || type.kind == :type_rvalue_ref
+        return true if type.spelling.match?(/\bVALUE\b/)
+
+        canonical = type.canonical
+        canonical = canonical.pointee.canonical while canonical.kind == :type_pointer &&
+                                                      canonical.pointee.canonical.kind != :type_function_proto
+        return true if canonical.kind == :type_pointer
+        canonical.spelling.sub(/\Aconst /, "").match?(/\A(Rice::|std::function<)/)
+      end
+
       ITERATOR_METHODS = ["begin", "end", "cbegin", "cend", "rbegin", "rend", "crbegin", "crend"].freeze
 
       # Common skip checks for functions and methods
@@ -825,12 +1302,17 @@ module RubyBindgen
         return if has_unsupported_rice_param_type?(cursor)
         return if has_skipped_return_type?(cursor)
 
+        # Record std:: types in the return and parameter types (function prototype)
+        @stl_collector.record(cursor.type)
+
         # Is this an iterator?
         if ITERATOR_METHODS.include?(cursor.spelling)
           return visit_cxx_iterator_method(cursor)
         end
 
-        signature = @signature_builder.method_signature(cursor)
+        return if @symbols.flag?(cursor, :fast_path) && visit_fast_path_method(cursor)
+
+        signature = callable_signature(cursor)
 
         result = Array.new
 
@@ -842,13 +1324,44 @@ module RubyBindgen
 
         is_template = cursor.semantic_parent.kind == :cursor_class_template
         qualified_parent = @type_speller.qualified_display_name(cursor.semantic_parent)
-        result << self.render_cursor(cursor, "cxx_method",
-                                     :name => name,
-                                     :is_template => is_template,
-                                     :signature => signature,
-                                     :args => args,
-                                     :return_buffer => return_buffer,
-                                     :qualified_parent => qualified_parent)
+        pairs = buffer_pairs(cursor, args)
+        if pairs.empty?
+          result << self.render_cursor(cursor, "cxx_method",
+                                       :name => name,
+                                       :is_template => is_template,
+                                       :signature => signature,
+                                       :args => args,
+                                       :return_buffer => return_buffer,
+                                       :no_gvl => no_gvl?(cursor),
+                                       :qualified_parent => qualified_parent)
+          disambiguated = disambiguated_name(cursor)
+          if disambiguated
+            result << self.render_cursor(cursor, "cxx_method",
+                                         :name => disambiguated,
+                                         :is_template => is_template,
+                                         :signature => signature,
+                                         :args => args,
+                                         :return_buffer => return_buffer,
+                                         :no_gvl => no_gvl?(cursor),
+                                         :qualified_parent => qualified_parent)
+          end
+        elsif cursor.static?
+          result << render_buffer_pairs(cursor, pairs, args, "define_singleton_function", name,
+                                        "#{qualified_parent}::#{cursor.spelling}", nil, return_buffer)
+        else
+          self_param = "#{cursor.const? ? "const " : ""}#{qualified_parent}& self"
+          result << render_buffer_pairs(cursor, pairs, args, "define_method", name,
+                                        "self.#{cursor.spelling}", self_param, return_buffer)
+        end
+
+        if @symbols.flag?(cursor, :vectorize) && vectorizable?(cursor)
+          if cursor.static?
+            result << render_vectorized(cursor, "define_singleton_function", "#{qualified_parent}::#{cursor.spelling}", nil)
+          else
+            self_param = "#{cursor.const? ? "const " : ""}#{qualified_parent}& self"
+            result << render_vectorized(cursor, "define_method", "self.#{cursor.spelling}", self_param)
+          end
+        end
 
         # Special handling for implementing #[](index, value)
         if cursor.spelling == "operator[]" && cursor.result_type.kind == :type_lvalue_ref &&
@@ -867,6 +1380,124 @@ module RubyBindgen
         result
       end
 
+      # Bind a `fast_path` method with a Ruby C API function that converts its
+      # arguments and result directly, instead of going through Rice's
+      # define_method dispatch (arity checks, overload resolution, keyword
+      # arguments). C++ exceptions are still translated by cpp_protect.
+      # Returns false, so the method is bound normally, when it does not qualify.
+      def visit_fast_path_method(cursor)
+        reason = fast_path_unsupported_reason(cursor)
+        if reason
+          warn "Warning: fast_path ignored for #{cursor.qualified_name}: #{reason}"
+          return false
+        end
+
+        parent = cursor.semantic_parent
+        params = cursor.type.arg_types.map { |arg_type| fast_path_type_spelling(arg_type) }
+        result_type = cursor.type.result_type
+        function_name = "fast_path_#{parent.cruby_name.delete_prefix("rb_c")}_" +
+                        cursor.ruby_name.gsub(/\W/) { |char| format("_%02x", char.ord) }
+        guards = [cursor, *cursor.ancestors_by_kind(:cursor_class_decl, :cursor_struct, :cursor_namespace)]
+                   .filter_map { |ancestor| @symbols.version(ancestor) }.reverse
+
+        @native_functions << render_cursor(cursor, "fast_path_function",
+                                              :function_name => function_name,
+                                              :qualified_name => cursor.qualified_name,
+                                              :class_type => @type_speller.qualified_display_name(parent),
+                                              :method => cursor.spelling,
+                                              :static => cursor.static?,
+                                              :params => params,
+                                              :return_type => result_type.kind == :type_void ? nil : fast_path_type_spelling(result_type),
+                                              :guards => guards)
+
+        define = cursor.static? ? "rb_define_singleton_method" : "rb_define_method"
+        @fast_path_registrations[parent.cruby_name][@symbols.version(cursor)] <<
+          "#{define}(#{parent.cruby_name}.value(), \"#{cursor.ruby_name}\", RUBY_METHOD_FUNC(#{function_name}), #{params.size});"
+        true
+      end
+
+      # Render the function that describes a memory_view class's memory from
+      # its configured accessor expressions, and return the registration.
+      def visit_memory_view(cursor, cpp_type, view)
+        function_name = "memory_view_#{cursor.cruby_name.delete_prefix("rb_c")}"
+        guards = [cursor, *cursor.ancestors_by_kind(:cursor_class_decl, :cursor_struct, :cursor_namespace)]
+                   .filter_map { |ancestor| @symbols.version(ancestor) }.reverse
+
+        @native_functions << render_cursor(cursor, "memory_view_function",
+                                           :function_name => function_name,
+                                           :class_type => cpp_type,
+                                           :view => view,
+                                           :guards => guards)
+        "RubyBindgen::MemoryView::define<#{function_name}>(#{cursor.cruby_name}.value());"
+      end
+
+      # Validate the memory_view section: class name => data, shape, either
+      # type or format plus item_size, and optional strides and readonly.
+      def memory_view_config(config)
+        return {} unless config
+        raise ArgumentError, "memory_view must map class names to accessor expressions" unless config.is_a?(Hash)
+
+        config.to_h do |name, entry|
+          name = name.to_s.delete_prefix("::")
+          raise ArgumentError, "memory_view #{name} must be a mapping" unless entry.is_a?(Hash)
+
+          unknown = entry.keys - [:data, :type, :format, :item_size, :shape, :strides, :readonly]
+          raise ArgumentError, "memory_view #{name} has unknown keys: #{unknown.join(", ")}" unless unknown.empty?
+          raise ArgumentError, "memory_view #{name} requires data" unless entry[:data]
+          raise ArgumentError, "memory_view #{name} requires shape" if Array(entry[:shape]).empty?
+          if entry[:type].nil? == entry[:format].nil?
+            raise ArgumentError, "memory_view #{name} requires either type or format"
+          end
+          raise ArgumentError, "memory_view #{name} format requires item_size" if entry[:format] && !entry[:item_size]
+
+          shape = Array(entry[:shape]).map(&:to_s)
+          strides = entry[:strides] && Array(entry[:strides]).map(&:to_s)
+          if strides && strides.size != shape.size
+            raise ArgumentError, "memory_view #{name} needs one stride per shape dimension"
+          end
+
+          [name, entry.merge(shape: shape, strides: strides,
+                             readonly: entry[:readonly] == false ? nil : entry[:readonly])]
+        end
+      end
+
+      FAST_PATH_TYPES = (FUNDAMENTAL_TYPES - [:type_void, :type_nullptr, :type_int128, :type_uint128,
+                                              :type_float128, :type_float16, :type_longdouble]).freeze
+
+      # Why a fast_path method has to use the regular Rice binding, or nil.
+      def fast_path_unsupported_reason(cursor)
+        parent = cursor.semantic_parent
+        return "only members of non-template classes are supported" unless [:cursor_class_decl, :cursor_struct].include?(parent.kind)
+        return "overloaded methods need Rice's overload resolution" if @overload_index.overloaded?(cursor)
+        return "no_gvl needs Rice's method dispatch" if @symbols.flag?(cursor, :no_gvl)
+        return "more than 15 parameters" if cursor.type.args_size > 15
+        return "default arguments need Rice's argument handling" if @signature_builder.arguments(cursor).any? { |arg| arg.include?("=") }
+
+        unless cursor.type.arg_types.all? { |arg_type| fast_path_type?(arg_type) }
+          return "parameters must be fundamental types or pointers/references to classes"
+        end
+
+        result_type = cursor.type.result_type
+        unless result_type.kind == :type_void || fast_path_type?(result_type, result: true)
+          return "the return type must be void, a fundamental type or a pointer to a class"
+        end
+        nil
+      end
+
+      def fast_path_type?(type, result: false)
+        canonical = type.canonical
+        return true if FAST_PATH_TYPES.include?(canonical.kind)
+
+        reference_kinds = result ? [:type_pointer] : [:type_pointer, :type_lvalue_ref]
+        reference_kinds.include?(canonical.kind) && canonical.pointee.canonical.kind == :type_record
+      end
+
+      # By-value fundamentals drop top level const, as Rice's own conversions do.
+      def fast_path_type_spelling(type)
+        spelling = @type_speller.type_spelling(type)
+        FAST_PATH_TYPES.include?(type.canonical.kind) ? spelling.delete_prefix("const ") : spelling
+      end
+
       def skip_namespace_forward_declaration?(cursor)
         return false unless cursor.kind == :cursor_class_decl
         return false unless cursor.opaque_declaration?
@@ -896,13 +1527,35 @@ module RubyBindgen
         is_template = cursor.semantic_parent.kind == :cursor_class_template
         qualified_parent = @type_speller.qualified_display_name(cursor.semantic_parent)
 
-        self.render_cursor(cursor, "cxx_iterator_method",
-                           :name => iterator_name,
-                           :begin_method => begin_method,
-                           :end_method => end_method,
-                           :signature => signature,
-                           :is_template => is_template,
-                           :qualified_parent => qualified_parent)
+        result = [self.render_cursor(cursor, "cxx_iterator_method",
+                                     :name => iterator_name,
+                                     :begin_method => begin_method,
+                                     :end_method => end_method,
+                                     :signature => signature,
+                                     :is_template => is_template,
+                                     :qualified_parent => qualified_parent)]
+
+        # With bulk_iterators: true, random access and contiguous iterators
+        # over numbers and POD structs also get to_a, to_packed and
+        # each_slice, which copy every element in one native loop. A class
+        # with both begin() and begin() const gets them once, from the const
+        # overload.
+        if @bulk_iterators && begin_method == "begin" && !is_template &&
+           (cursor.const? || !const_begin?(cursor.semantic_parent)) &&
+           (value_type = @iterator_collector.bulk_value_type(cursor.result_type))
+          @includes << "#include <cstring>"
+          @includes << "#include <limits>"
+          result << self.render_cursor(cursor, "iterator_bulk_methods",
+                                       :receiver => cursor.const? ? "const #{qualified_parent}" : qualified_parent,
+                                       :begin_method => begin_method,
+                                       :end_method => end_method,
+                                       :value_type => @type_speller.type_spelling(value_type.unqualified_type))
+        end
+        result
+      end
+
+      def const_begin?(cursor)
+        cursor.find_by_kind(false, :cursor_cxx_method).any? { |method| method.spelling == "begin" && method.const? }
       end
 
       # Render a conversion operator such as `operator bool()` or `operator T*()`.
@@ -934,6 +1587,7 @@ module RubyBindgen
 
         result_type_spelling = @type_speller.type_spelling(result_type)
         is_const = cursor.const?
+        @stl_collector.record(result_type)
 
         # For class templates, the result type may contain "type-parameter-X_Y" which
         # generates invalid Ruby method names. Use generic names instead.
@@ -973,7 +1627,15 @@ module RubyBindgen
         end
 
         under = find_under(cursor)
-        children = render_children(cursor, indentation: 2, chain: true, terminate: true, strip: true)
+        if @ractor_safe
+          # Rice publishes each value as a constant holding a wrapped object,
+          # which cannot be shared between Ractors. The type is still
+          # registered so functions can take and return it.
+          warn "Warning: ractor_safe skips values of #{cursor.qualified_name}: enum values are not shareable between Ractors"
+          children = ";"
+        else
+          children = render_children(cursor, indentation: 2, chain: true, terminate: true, strip: true)
+        end
         self.render_cursor(cursor, "enum_decl", :under => under, :children => children)
       end
 
@@ -1011,6 +1673,8 @@ module RubyBindgen
         return if has_skipped_return_type?(cursor)
         return unless has_export_macro?(cursor)
 
+        @stl_collector.record(cursor.type)
+
         if cursor.spelling.start_with?('operator') && !cursor.spelling.match?(/^operator\w/)
           return self.visit_operator_non_member(cursor)
         end
@@ -1018,19 +1682,36 @@ module RubyBindgen
         name = cursor.ruby_name
         args = @signature_builder.arguments(cursor)
 
-        signature = @signature_builder.method_signature(cursor)
+        signature = callable_signature(cursor)
 
         # Check if return type should use ReturnBuffer
         return_buffer = @signature_builder.buffer_type?(cursor.type.result_type)
 
         under = cursor.ancestors_by_kind(:cursor_namespace)
                      .find { |a| !a.inline_namespace? }
-        self.render_cursor(cursor, "function",
-                           :under => under,
-                           :name => name,
-                           :signature => signature,
-                           :args => args,
-                           :return_buffer => return_buffer)
+
+        definition = under ? "#{under.cruby_name}.define_module_function" : "define_global_function"
+        pairs = buffer_pairs(cursor, args)
+        result = Array.new
+        if pairs.empty?
+          [name, disambiguated_name(cursor)].compact.each do |function_name|
+            result << self.render_cursor(cursor, "function",
+                                         :under => under,
+                                         :name => function_name,
+                                         :signature => signature,
+                                         :args => args,
+                                         :return_buffer => return_buffer,
+                                         :no_gvl => no_gvl?(cursor))
+          end
+        else
+          result << render_buffer_pairs(cursor, pairs, args, definition, name, cursor.qualified_name, nil,
+                                        return_buffer, terminate: true)
+        end
+
+        if @symbols.flag?(cursor, :vectorize) && vectorizable?(cursor)
+          result << render_vectorized(cursor, definition, cursor.qualified_name, nil, terminate: true)
+        end
+        result
       end
 
       # Render simple object-like macros as Ruby constants when the macro body is
@@ -1042,9 +1723,11 @@ module RubyBindgen
         return unless tokens.tokens[1].kind == :literal
         return if skip_symbol?(cursor)
 
+        qualified_name = tokens.tokens[0].spelling
+        qualified_name = frozen_string(qualified_name) if @ractor_safe && tokens.tokens[1].spelling.start_with?('"')
         self.render_cursor(cursor, "constant",
                            :name => tokens.tokens[0].spelling.upcase_first,
-                           :qualified_name => tokens.tokens[0].spelling)
+                           :qualified_name => qualified_name)
       end
 
       # Render a namespace as a Ruby module, except for inline namespaces which
@@ -1085,11 +1768,55 @@ module RubyBindgen
         return if cursor.availability == :deprecated
         return if unsupported_rice_attribute_type?(cursor.type)
 
+        @stl_collector.record(cursor.type)
         qualified_parent = @type_speller.qualified_display_name(cursor.semantic_parent)
+
+        # With field_references: true, class and container fields are read
+        # through a reference the Ruby object keeps the owner alive for,
+        # instead of define_attr's copy, and written by assigning in place.
+        if @field_references && reference_field_type?(cursor.type)
+          type = cursor.type
+          return self.render_cursor(cursor, "field_reference",
+                                    :qualified_parent => qualified_parent,
+                                    :field_type => @type_speller.type_spelling(type),
+                                    :writable => !type.const_qualified? && type.declaration.copy_assignable?)
+        end
+
+        # With array_views: true, numeric fixed-size arrays are read as a
+        # Rice::Buffer over the struct's storage and written in bulk.
+        if @array_views && array_view_type?(cursor.type)
+          type = cursor.type
+          return self.render_cursor(cursor, "array_view",
+                                    :qualified_parent => qualified_parent,
+                                    :element_type => @type_speller.type_spelling(type.element_type),
+                                    :size => type.size)
+        end
+
         self.render_cursor(cursor, "field_decl",
                            :qualified_parent => qualified_parent)
       end
 
+      # One-dimensional arrays of mutable numbers, such as float m[16]. char
+      # arrays are strings and bool has no packed representation.
+      def array_view_type?(type)
+        return false unless type.kind == :type_constant_array
+        return false if type.element_type.const_qualified?
+
+        element = type.element_type.canonical
+        element.kind != :type_void && BufferPairs::ELEMENT_KINDS.include?(element.kind)
+      end
+
+      # Class types Rice wraps rather than converting to a Ruby value, such
+      # as std::vector or a user struct. std::string and the other
+      # RICE_NATIVE_TYPES become new Ruby objects either way.
+      def reference_field_type?(type)
+        canonical = type.canonical
+        return false unless canonical.kind == :type_record
+
+        decl = canonical.declaration
+        !(decl.location.in_system_header? && RICE_NATIVE_TYPES.include?(decl.spelling))
+      end
+
       # Record a free operator for later rendering onto the target class.
       # These are grouped and emitted after normal members so cross-file
       # `Data_Type<T>()` references can be handled in one pass.
@@ -1321,7 +2048,7 @@ module RubyBindgen
                 end
               elsif !@auto_generated_bases.include?(base_spelling)
                 # No typedef - auto-generate
-                result = auto_generate_base_class(base_ref, base_spelling, under)
+                result = auto_generate_base_class(base_ref, base_spelling, under, guard_version(cursor))
               end
             elsif base_class_template && !base_class_template.location.in_system_header?
               # Base template is from an included file — include its .ipp so the
@@ -1337,6 +2064,23 @@ module RubyBindgen
         end
 
         template_specialization = @template_resolver.specialization_spelling(cursor, underlying_type, cursor_template)
+        @stl_collector.record(underlying_type)
+
+        # Another file already registers this specialization - look up its
+        # Data_Type and alias it under this typedef's name instead.
+        status, owner = claim_specialization(template_specialization, guard_version(cursor))
+        if owner && status != :register
+          reference = self.render_cursor(cursor, "class_template_reference",
+                                         :template_specialization => template_specialization,
+                                         :owner => owner[:inits].join(" or "),
+                                         :under => under)
+          if status == :reference
+            @classes[cursor.cruby_name] = template_specialization
+            return result + reference
+          end
+        end
+
+        record_instantiation(cursor_template, template_specialization, template_arguments, @symbols.version(cursor))
 
         # If template is defined in a different file, include its .ipp for the _instantiate builder
         template_owner = template_cursor_definition(cursor_template)
@@ -1350,18 +2094,20 @@ module RubyBindgen
         end
 
         @classes[cursor.cruby_name] = template_specialization
-        result + self.render_cursor(cursor, "class_template_specialization",
-                           :cursor_template => cursor_template,
-                           :template_specialization => template_specialization,
-                           :template_arguments => template_arguments,
-                           :base_ref => base_ref,
-                           :base => base,
-                           :base_spelling => base_spelling,
-                           :under => under)
+        registration = self.render_cursor(cursor, "class_template_specialization",
+                                          :cursor_template => cursor_template,
+                                          :template_specialization => template_specialization,
+                                          :template_arguments => template_arguments,
+                                          :base_ref => base_ref,
+                                          :base => base,
+                                          :base_spelling => base_spelling,
+                                          :under => under)
+        result + (status == :fallback ? fallback_guard(owner, registration, reference) : registration)
       end
 
       # Auto-instantiate a class template used as a parameter type without a typedef.
-      def auto_instantiate_template(cursor_template, instantiated_type, type, under)
+      # version is the guard around the code that uses it.
+      def auto_instantiate_template(cursor_template, instantiated_type, type, under, version)
         return "" unless cursor_template
         match = instantiated_type.match(/\<(.*)\>/)
         return "" unless match
@@ -1373,18 +2119,24 @@ module RubyBindgen
         ruby_class_name = @namer.apply_rename_types(ruby_class_name)
         cruby_name = "rb_c#{ruby_class_name}"
         return "" if @classes.key?(cruby_name)
+        status, owner = claim_specialization(instantiated_type, version)
+        return "" if status == :reference
 
         @classes[cruby_name] = instantiated_type
-        render_template("class_template_specialization",
-                        :cursor => cursor_template, :cursor_template => cursor_template,
-                        :template_specialization => instantiated_type, :template_arguments => match[1],
-                        :cruby_name => cruby_name, :base_ref => nil, :base => nil,
-                        :base_spelling => nil, :under => under)
+        @stl_collector.record(type)
+        record_instantiation(cursor_template, instantiated_type, match[1], nil)
+        registration = render_template("class_template_specialization",
+                                       :cursor => cursor_template, :cursor_template => cursor_template,
+                                       :template_specialization => instantiated_type, :template_arguments => match[1],
+                                       :cruby_name => cruby_name, :base_ref => nil, :base => nil,
+                                       :base_spelling => nil, :under => under)
+        status == :fallback ? fallback_guard(owner, registration) : registration
       end
 
       # Auto-generate a base class definition when no typedef exists for it.
       # When recursive: true, also generates any base classes of the base class.
-      def auto_generate_base_class(base_ref, base_spelling, under, recursive: true)
+      # version is the guard around the code of the derived class.
+      def auto_generate_base_class(base_ref, base_spelling, under, version, recursive: true)
         base_template_ref = base_ref.find_first_by_kind(false, :cursor_template_ref)
         return "" unless base_template_ref
 
@@ -1404,6 +2156,8 @@ module RubyBindgen
 
         base_template_arguments = @template_resolver.template_argument_texts(base_template_arguments_text)
         return "" if base_template_arguments.empty?
+        status, owner = claim_specialization(base_spelling, version)
+        return "" if status == :reference
 
         result = ""
         base_base_spelling = nil
@@ -1423,7 +2177,7 @@ module RubyBindgen
               base_base_spelling = @template_resolver.resolve_base_specifier_spelling(base_base_ref, substitutions: subs)
 
               if base_base_spelling && !@type_index.typedef_for(base_base_spelling) && !@auto_generated_bases.include?(base_base_spelling)
-                result = auto_generate_base_class(base_base_ref, base_base_spelling, under)
+                result = auto_generate_base_class(base_base_ref, base_base_spelling, under, version)
               end
             end
           end
@@ -1434,17 +2188,19 @@ module RubyBindgen
         cruby_name = "rb_c#{ruby_name}"
 
         @classes[cruby_name] = base_spelling
-        result + render_template("auto_generated_base_class",
-                        :cruby_name => cruby_name, :ruby_name => ruby_name,
-                        :base_spelling => base_spelling, :base_base_spelling => base_base_spelling,
-                        :base_template => base_template, :template_arguments => base_template_arguments_text,
-                        :under => under)
+        record_instantiation(base_template, base_spelling, base_template_arguments_text, nil)
+        registration = render_template("auto_generated_base_class",
+                                       :cruby_name => cruby_name, :ruby_name => ruby_name,
+                                       :base_spelling => base_spelling, :base_base_spelling => base_base_spelling,
+                                       :base_template => base_template, :template_arguments => base_template_arguments_text,
+                                       :under => under)
+        result + (status == :fallback ? fallback_guard(owner, registration) : registration)
       end
 
       # Auto-generate a template base class for a non-template derived class.
       # For example: class PlaneWarper : public WarperBase<PlaneProjector>
-      def auto_generate_template_base_for_class(base_specifier, base_spelling, under)
-        auto_generate_base_class(base_specifier, base_spelling, under, recursive: false)
+      def auto_generate_template_base_for_class(base_specifier, base_spelling, under, version)
+        auto_generate_base_class(base_specifier, base_spelling, under, version, recursive: false)
       end
 
       # Render a union plus any embedded unions/structs that need to appear first.
@@ -1489,6 +2245,13 @@ module RubyBindgen
         # Skip compiler/cuda keywords like __device__ __forceinline__
         return if cursor.spelling.match(/^__.*__$/)
 
+        @stl_collector.record(cursor.type)
+
+        if @ractor_safe && (hazard = ractor_hazard(cursor))
+          warn "Warning: ractor_safe skips #{cursor.qualified_name}: #{hazard}"
+          return
+        end
+
         # Const variables become Ruby constants
         if cursor.type.const_qualified?
           visit_variable_constant(cursor)
@@ -1509,9 +2272,51 @@ module RubyBindgen
 
       # Render one constant definition for an enum value, macro, or variable.
       def visit_variable_constant(cursor)
+        qualified_name = @type_speller.qualified_display_name(cursor)
+        qualified_name = frozen_string(qualified_name, cursor.type) if @ractor_safe && string_type?(cursor.type)
         self.render_cursor(cursor, "constant",
                            :name => cursor.spelling.upcase_first,
-                           :qualified_name => @type_speller.qualified_display_name(cursor))
+                           :qualified_name => qualified_name)
+      end
+
+      # With `ractor_safe: true` the extension is marked safe to call from any
+      # Ractor, so every Ruby object it publishes must be shareable and no
+      # binding may share mutable C++ state. Returns why a variable breaks
+      # that, or nil. Mutable variables are skipped rather than snapshotted,
+      # and constants must be numbers or char strings (which are frozen). Enum
+      # values are wrapped Rice objects, so enum constants are skipped too.
+      def ractor_hazard(cursor)
+        unless cursor.type.const_qualified?
+          return CURSOR_CLASSES.include?(cursor.semantic_parent.kind) ? "mutable static member" : "mutable global variable"
+        end
+
+        canonical = cursor.type.canonical
+        return nil if FUNDAMENTAL_TYPES.include?(canonical.kind) || string_type?(cursor.type)
+
+        "constant of type #{cursor.type.spelling} is not shareable between Ractors"
+      end
+
+      # const char* and char arrays of known size become Ruby strings.
+      # signed char and unsigned char arrays are byte tables, not text.
+      def string_type?(type)
+        canonical = type.canonical
+        element = case canonical.kind
+                  when :type_pointer then canonical.pointee
+                  when :type_constant_array then canonical.element_type
+                  end
+        element && [:type_char_s, :type_char_u].include?(element.canonical.kind)
+      end
+
+      # A frozen, and so Ractor shareable, Ruby string for a C string
+      # expression. A null pointer becomes nil, and an array is read no
+      # further than its size even without a terminating NUL. String
+      # literals from macros are arrays.
+      def frozen_string(expression, type = nil)
+        if type && type.canonical.kind == :type_pointer
+          "#{expression} ? Rice::Object(rb_obj_freeze(rb_str_new_cstr(#{expression}))) : Rice::Object(Qnil)"
+        else
+          "Rice::Object(rb_obj_freeze(rb_str_new(#{expression}, strnlen(#{expression}, sizeof(#{expression})))))"
+        end
       end
 
       # Render the optional project-level wrapper files that call every generated
@@ -1519,18 +2324,37 @@ module RubyBindgen
       def create_project_files
         return unless @project
 
-        # Create master hpp/cpp files to include all the files we generated
-        basename = "#{project}-rb"
+        # With modules, each module gets its own extension that loads the
+        # modules it depends on and then runs its files' Init functions.
+        @modules.modules.each do |extension_module|
+          init_names = @init_names.select { |rice_header, _| @init_modules[rice_header] == extension_module.name }
+          create_extension_files("#{project}_#{extension_module.name}", init_names,
+                                 extension_module.depends.map { |name| "#{project}_#{name}" })
+        end
+
+        # The main extension loads every module, then runs the remaining files
+        init_names = @init_names.select { |rice_header, _| @init_modules[rice_header].nil? }
+        create_extension_files(project, init_names,
+                               @modules.modules.map { |extension_module| "#{project}_#{extension_module.name}" })
+      end
+
+      # Create master hpp/cpp files for one extension that include the files it
+      # owns and `rb_require` the extensions it depends on.
+      def create_extension_files(extension, init_names, requires)
+        basename = "#{extension}-rb"
         rice_header = "#{basename}.hpp"
         rice_cpp = "#{basename}.cpp"
-        init_function = "Init_#{project}"
+        init_function = "Init_#{extension}"
 
         content = render_template("project.hpp",
-                                  :init_name => init_function, :init_names => @init_names)
+                                  :init_name => init_function, :init_names => init_names)
         self.outputter.write(rice_header, content)
 
+        init_stats = @profile_init ? @init_stats.slice(*init_names.keys) : nil
         content = render_template("project.cpp",
-                                  :project_header => rice_header, :init_name => init_function, :init_names => @init_names)
+                                  :project_header => rice_header, :init_name => init_function, :init_names => init_names,
+                                  :requires => requires, :init_stats => init_stats,
+                                  :ractor_safe => @ractor_safe)
         self.outputter.write(rice_cpp, content)
       end
 
@@ -1554,6 +2378,12 @@ module RubyBindgen
         render_template(template, local_variables.merge(:cursor => cursor))
       end
 
+      # Count what each rendered template registers for profile_init.
+      def render_template(template, local_variables = {})
+        @registration_stats.record(template)
+        super
+      end
+
       def template_cursor_definition(cursor)
         return nil unless cursor
 
@@ -0,0 +1,107 @@
+require 'set'
+
+module RubyBindgen
+  module Generators
+    class Rice
+      # Records which standard library types appear in emitted bindings so the
+      # generated include header can pull in just the Rice STL headers those
+      # types need instead of the whole of <rice/stl.hpp>.
+      #
+      # Unlike IteratorCollector this state is project-wide: it accumulates
+      # across translation units and is read once in visit_end when the
+      # include header is written.
+      class StlCollector
+        # Rice STL headers keyed by the std:: declaration spelling that needs
+        # them. Declaration spelling (not qualified_name) is used so inline
+        # namespaces such as std::__cxx11 or std::__1 do not matter.
+        HEADERS = {
+          "basic_string" => "string",
+          "basic_string_view" => "string_view",
+          "complex" => "complex",
+          "exception_ptr" => "exception_ptr",
+          "function" => "function",
+          "map" => "map",
+          "monostate" => "monostate",
+          "multimap" => "multimap",
+          "optional" => "optional",
+          "pair" => "pair",
+          "path" => "filesystem",
+          "reference_wrapper" => "reference_wrapper",
+          "set" => "set",
+          "shared_ptr" => "shared_ptr",
+          "tuple" => "tuple",
+          "type_index" => "type_index",
+          "type_info" => "type_info",
+          "unique_ptr" => "unique_ptr",
+          "unordered_map" => "unordered_map",
+          "variant" => "variant",
+          "vector" => "vector"
+        }.freeze
+
+        # Rice's own <rice/stl.hpp> include order. Several headers build on
+        # earlier ones, so selected headers are always emitted in this order.
+        ORDER = %w[
+          exception exception_ptr string string_view complex filesystem
+          optional reference_wrapper pair map monostate multimap set tuple
+          type_index type_info variant unique_ptr shared_ptr function
+          unordered_map vector
+        ].freeze
+
+        # Headers every binding needs. Generated `inspect` methods return
+        # std::string and Rice translates std::exception subclasses.
+        REQUIRED = %w[exception string].freeze
+        private_constant :REQUIRED
+
+        def initialize
+          @headers = Set.new(REQUIRED)
+        end
+
+        def clear
+          @headers = Set.new(REQUIRED)
+        end
+
+        # Record every std:: type reachable from `type`, including through
+        # pointers, references, arrays, function prototypes and template
+        # arguments (std::vector<std::pair<int, std::string>> records vector,
+        # pair and string).
+        def record(type, visited = Set.new)
+          return if type.nil? || type.kind == :type_invalid
+
+          case type.kind
+          when :type_pointer, :type_block_pointer
+            return record(type.pointee, visited)
+          when :type_lvalue_ref, :type_rvalue_ref
+            return record(type.non_reference_type, visited)
+          when :type_constant_array, :type_incomplete_array, :type_variable_array, :type_dependent_sized_array
+            return record(type.element_type, visited)
+          when :type_function_proto, :type_function_no_proto
+            record(type.result_type, visited)
+            type.arg_types.each { |arg_type| record(arg_type, visited) }
+            return
+          end
+
+          canonical = type.canonical
+          return unless visited.add?(canonical.spelling)
+
+          decl = canonical.declaration
+          return if decl.kind == :cursor_no_decl_found
+
+          if decl.location.in_system_header? && decl.qualified_name&.start_with?("std::")
+            header = HEADERS[decl.spelling]
+            @headers << header if header
+          end
+
+          canonical.num_template_arguments.times do |i|
+            record(canonical.template_argument_type(i), visited)
+          end
+        end
+
+        # Selected Rice STL headers in dependency order, e.g. "rice/stl/vector.hpp".
+        def headers
+          ORDER.select { |name| @headers.include?(name) }
+               .map { |name| "rice/stl/#{name}.hpp" }
+        end
+      end
+    end
+  end
+end
@@ -0,0 +1,63 @@
+require 'set'
+
+module RubyBindgen
+  module Generators
+    class Rice
+      # Project-wide record of the class template builder calls
+      # (e.g. `Matrix_instantiate<double, 4>(...)`) emitted while generating
+      # bindings.
+      #
+      # With `extern_templates: true` every translation unit declares the
+      # builder specializations it calls `extern template`, and visit_end
+      # writes one explicit-instantiation file per `-rb.ipp` that defines
+      # them. Each specialization is then compiled once for the whole project
+      # instead of once per including translation unit.
+      class TemplateInstantiations
+        # One builder specialization. `version` is the version guard of the
+        # symbol that requested it (nil when unguarded).
+        Instantiation = Data.define(:builder, :arguments, :specialization, :ipp, :version) do
+          def key
+            "#{builder}<#{arguments}>"
+          end
+
+          def declaration
+            "template Rice::Data_Type<#{specialization}> #{builder}<#{arguments}>(Rice::Module parent, const char* name);"
+          end
+        end
+
+        def initialize
+          @instantiations = Hash.new { |h, k| h[k] = {} }
+          @headers = Hash.new { |h, k| h[k] = Set.new }
+        end
+
+        def clear
+          @instantiations.clear
+          @headers.clear
+        end
+
+        def empty?
+          @instantiations.empty?
+        end
+
+        # Record `instantiation` as requested by bindings generated from
+        # `headers`. The instantiation file includes those headers so template
+        # arguments declared in them are visible. A specialization requested
+        # both with and without a version guard is instantiated unguarded.
+        def add(instantiation, headers)
+          existing = @instantiations[instantiation.ipp][instantiation.key]
+          if existing.nil? || (existing.version && instantiation.version.nil?)
+            @instantiations[instantiation.ipp][instantiation.key] = instantiation
+          end
+          @headers[instantiation.ipp].merge(headers)
+        end
+
+        # Yields each `-rb.ipp` path with its instantiations and requesting headers.
+        def each_ipp
+          @instantiations.each do |ipp, instantiations|
+            yield ipp, instantiations.values, @headers[ipp].to_a
+          end
+        end
+      end
+    end
+  end
+end
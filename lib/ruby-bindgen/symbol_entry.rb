@@ -1,21 +1,27 @@
 module RubyBindgen
   class SymbolEntry
-    attr_reader :version, :signature
+    attr_reader :version, :signature, :flags
 
-    def initialize(skip: false, version: nil, signature: nil)
+    def initialize(skip: false, version: nil, signature: nil, flags: [])
       @skip = skip
       @version = version
       @signature = signature
+      @flags = flags.dup
     end
 
     def skip?
       @skip
     end
 
-    def merge(skip: false, version: nil, signature: nil)
+    def flag?(flag)
+      @flags.include?(flag)
+    end
+
+    def merge(skip: false, version: nil, signature: nil, flags: [])
       @skip = true if skip
       @version = version if version
       @signature = signature if signature
+      @flags |= flags
     end
   end
 end
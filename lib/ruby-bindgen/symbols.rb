@@ -3,10 +3,14 @@ module RubyBindgen
   # name strings supplied in the YAML symbols config.
   #
   # Owns the storage (an exact-match hash plus a list of regex entries) and
-  # the policy queries (skip?, version, override). Delegates name
+  # the policy queries (skip?, version, override, flag?). Delegates name
   # enumeration to SymbolCandidates so the matching logic is shared with
   # Namer / NameMapper.
   class Symbols
+    # Opt-in code generation features enabled per symbol, each a list of
+    # names or /regex/ patterns under the same key in the symbols config.
+    FLAGS = [:fast_path, :no_gvl, :buffer_pairs, :vectorize, :disambiguate_overloads, :blocking].freeze
+
     def initialize(config = {})
       @exact = {}
       @regex = []
@@ -24,6 +28,12 @@ module RubyBindgen
       (config[:overrides] || {}).each do |name, signature|
         add_entry(name.to_s, signature: signature)
       end
+
+      FLAGS.each do |flag|
+        (config[flag] || []).each do |name|
+          add_entry(name, flags: [flag])
+        end
+      end
     end
 
     # Look up a cursor by trying each of its candidate names.
@@ -83,23 +93,32 @@ module RubyBindgen
       entry&.signature
     end
 
+    # Check if a symbol flag (see FLAGS) is enabled for a cursor. Unlike
+    # lookup, every matching entry is checked, so an exact entry for one
+    # setting does not hide a regex entry that sets the flag.
+    def flag?(cursor, flag)
+      candidates = SymbolCandidates.new(cursor).map { |name| SymbolCandidates.normalize_signature(name) }
+      candidates.any? { |name| @exact[name]&.flag?(flag) } ||
+        @regex.any? { |pattern, entry| entry.flag?(flag) && candidates.any? { |name| pattern.match?(name) } }
+    end
+
     def has_versions?
       @exact.any? { |_, entry| entry.version } || @regex.any? { |_, entry| entry.version }
     end
 
     private
 
-    def add_entry(name, skip: false, version: nil, signature: nil)
+    def add_entry(name, skip: false, version: nil, signature: nil, flags: [])
       return if name.nil?
       if name.start_with?('/') && name.end_with?('/') && name.length > 2
-        @regex << [Regexp.new(name[1..-2]), SymbolEntry.new(skip: skip, version: version, signature: signature)]
+        @regex << [Regexp.new(name[1..-2]), SymbolEntry.new(skip: skip, version: version, signature: signature, flags: flags)]
       else
         key = SymbolCandidates.normalize_signature(name)
         existing = @exact[key]
         if existing
-          existing.merge(skip: skip, version: version, signature: signature)
+          existing.merge(skip: skip, version: version, signature: signature, flags: flags)
         else
-          @exact[key] = SymbolEntry.new(skip: skip, version: version, signature: signature)
+          @exact[key] = SymbolEntry.new(skip: skip, version: version, signature: signature, flags: flags)
         end
       end
     end
@@ -0,0 +1,183 @@
+require 'json'
+
+module RubyBindgen
+  # Attributes compile time in a build made with the CMake `time_trace`
+  # presets to generated `-rb.cpp` files and to the C++ types they bind.
+  #
+  # Clang's `-ftime-trace` writes one Chrome trace file next to each object
+  # file (`CMakeFiles/<target>.dir/core/mat-rb.cpp.json`). Each trace is matched
+  # to a file in the Rice manifest (`manifest: true`), and the self time of each
+  # event that names a function or class (template instantiations, parsing,
+  # code generation, optimization) is charged to the first bound type the
+  # event's detail mentions. Time no event can be charged to stays with the
+  # file as unattributed.
+  class TraceReport
+    UNATTRIBUTED = "(unattributed)"
+
+    # Total compile time, in seconds, per generated file and per bound type.
+    FileTime = Data.define(:file, :seconds, :types)
+    TypeTime = Data.define(:name, :seconds, :files)
+
+    attr_reader :build_dir, :manifest_path
+
+    def initialize(build_dir, manifest_path = nil)
+      @build_dir = build_dir
+      raise ArgumentError, "Build directory not found: #{build_dir}" unless File.directory?(build_dir)
+
+      @manifest_path = manifest_path || default_manifest_path
+      raise ArgumentError, "Manifest not found: #{@manifest_path}; generate the Rice bindings with manifest: true" unless File.exist?(@manifest_path)
+
+      manifest = JSON.parse(File.read(@manifest_path))
+      @manifest_files = manifest.fetch("files")
+      @type_names = @manifest_files.values.flat_map { |entry| Array(entry["types"]) }.to_h do |type|
+        [type_name(type), true]
+      end
+    end
+
+    def trace_files
+      @trace_files ||= Dir.glob(File.join(@build_dir, "**", "*-rb.cpp.json")).sort
+    end
+
+    # Generated files, slowest first.
+    def files
+      analyze
+      @files
+    end
+
+    # Bound types, slowest first. Time that could not be attributed is
+    # reported as UNATTRIBUTED.
+    def types
+      analyze
+      @types
+    end
+
+    def total_seconds
+      files.sum(&:seconds)
+    end
+
+    def to_h(top = nil)
+      { manifest: @manifest_path,
+        trace_files: trace_files.size,
+        total_seconds: total_seconds.round(3),
+        types: types.take(top || types.size).map do |type|
+          { name: type.name, seconds: type.seconds.round(3), files: type.files }
+        end,
+        files: files.take(top || files.size).map do |file|
+          { file: file.file, seconds: file.seconds.round(3),
+            types: file.types.map { |name, seconds| { name: name, seconds: seconds.round(3) } } }
+        end }
+    end
+
+    def to_s(top = 20)
+      lines = []
+      lines << format("Compile time by bound type (%d trace files, %.1fs total)", trace_files.size, total_seconds)
+      types.take(top).each do |type|
+        lines << format("  %9.2fs  %s (%d %s)", type.seconds, type.name, type.files.size, type.files.size == 1 ? "file" : "files")
+      end
+      lines << ""
+      lines << "Compile time by generated file"
+      files.take(top).each do |file|
+        slowest = file.types.reject { |name, _| name == UNATTRIBUTED }.first
+        detail = slowest ? format("  %s %.2fs", slowest[0], slowest[1]) : ""
+        lines << format("  %9.2fs  %s%s", file.seconds, file.file, detail)
+      end
+      lines.join("\n") + "\n"
+    end
+
+    private
+
+    def default_manifest_path
+      cache = File.join(@build_dir, "CMakeCache.txt")
+      source_dir = if File.exist?(cache)
+                     File.foreach(cache).find { |line| line.start_with?("CMAKE_HOME_DIRECTORY:") }&.split("=", 2)&.last&.strip
+                   end
+      File.join(source_dir || @build_dir, Generators::Rice::MANIFEST)
+    end
+
+    def analyze
+      return if @files
+
+      by_type = Hash.new { |hash, name| hash[name] = { seconds: 0.0, files: [] } }
+      @files = trace_files.filter_map do |trace_file|
+        file = manifest_key(trace_file)
+        next unless file
+
+        file_types = attribute(JSON.parse(File.read(trace_file)))
+        file_types.each do |name, seconds|
+          by_type[name][:seconds] += seconds
+          by_type[name][:files] << file
+        end
+        FileTime.new(file: file, seconds: file_types.values.sum, types: file_types.sort_by { |_, seconds| -seconds })
+      end.sort_by { |file| -file.seconds }
+
+      @types = by_type.map do |name, totals|
+        TypeTime.new(name: name, seconds: totals[:seconds], files: totals[:files].uniq.sort)
+      end.sort_by { |type| -type.seconds }
+    end
+
+    # CMake puts a source's object file, and so its trace, at
+    # CMakeFiles/<target>.dir/<source path relative to the project>.json.
+    def manifest_key(trace_file)
+      path = trace_file.delete_prefix(@build_dir).delete_prefix("/").delete_suffix(".json")
+      path = path.sub(%r{\A.*?CMakeFiles/[^/]+\.dir/}, "")
+      return path if @manifest_files.key?(path)
+
+      @manifest_files.keys.select { |key| path.end_with?("/#{key}") }.max_by(&:length)
+    end
+
+    # Seconds per bound type for one trace, including UNATTRIBUTED.
+    def attribute(trace)
+      events = trace.fetch("traceEvents", []).select do |event|
+        event["ph"] == "X" && !event["name"].to_s.start_with?("Total ")
+      end
+      total = events.select { |event| event["name"] == "ExecuteCompiler" }.sum { |event| event["dur"].to_i }
+
+      result = Hash.new(0.0)
+      self_times(events).each do |event, microseconds|
+        name = type_for(event.dig("args", "detail"))
+        result[name] += microseconds / 1_000_000.0 if name
+      end
+
+      attributed = result.values.sum
+      total_seconds = total / 1_000_000.0
+      result[UNATTRIBUTED] += total_seconds - attributed if total_seconds > attributed
+      result
+    end
+
+    # Events nest (an instantiation includes the instantiations it triggers),
+    # so each event is charged only for the time not spent in its children.
+    def self_times(events)
+      sorted = events.sort_by { |event| [event["tid"].to_i, event["ts"].to_i, -event["dur"].to_i] }
+      times = {}.compare_by_identity
+      stack = []
+      sorted.each do |event|
+        start = event["ts"].to_i
+        stack.pop while stack.any? && (stack.last["tid"] != event["tid"] || stack.last["ts"].to_i + stack.last["dur"].to_i <= start)
+        times[stack.last] -= event["dur"].to_i if stack.any?
+        times[event] = event["dur"].to_i
+        stack << event
+      end
+      times
+    end
+
+    # The first bound type named in an event's detail, such as
+    # "Rice::Data_Type<cv::Mat_<float>>::define_method<...>" => "cv::Mat_".
+    # Member names are matched by their enclosing type.
+    def type_for(detail)
+      return nil unless detail.is_a?(String)
+
+      detail.scan(/[A-Za-z_]\w*(?:::[A-Za-z_]\w*)*/) do |identifier|
+        parts = identifier.split("::")
+        parts.length.downto(1) do |length|
+          candidate = parts.take(length).join("::")
+          return candidate if @type_names.key?(candidate)
+        end
+      end
+      nil
+    end
+
+    def type_name(type)
+      type.to_s.delete_prefix("::")[/\A[^<]*/].strip
+    end
+  end
+end
@@ -36,4 +36,10 @@ module Structs
            :b, :bool,
            :u8, :uint8_t
   end
+
+  class ArrayNamesStruct < FFI::Struct
+    layout :size, [:float, 2],
+           :values, [:int, 4],
+           :weights, [:double, 2]
+  end
 end
@@ -38,6 +38,9 @@ void Init_Buffers()
   define_global_function<void(*)(unsigned char *, size_t)>("process_unsigned_buffer", &processUnsignedBuffer,
     ArgBuffer("data"), Arg("size"));
 
+  define_global_function<int(*)(int *, int, int)>("scale_int_buffer", &scaleIntBuffer,
+    ArgBuffer("data"), Arg("count"), Arg("factor"));
+
   define_global_function<void(*)(const int *, int)>("read_int_buffer", &readIntBuffer,
     ArgBuffer("data"), Arg("size"));
 
@@ -93,7 +96,9 @@ void Init_Buffers()
     .define_method<BufferClass **(DataProcessor::*)()>("get_objects", &DataProcessor::getObjects,
       ReturnBuffer())
     .define_method<void(DataProcessor::*)(double *, double *)>("compute_stats", &DataProcessor::computeStats,
-      ArgBuffer("mean"), ArgBuffer("stddev"));
+      ArgBuffer("mean"), ArgBuffer("stddev"))
+    .define_method<void(DataProcessor::*)(const float *, int, float, int)>("mix_samples", &DataProcessor::mixSamples,
+      ArgBuffer("samples"), Arg("count"), Arg("samples_view"), Arg("self"));
 
   define_global_function<void(*)(int *, int, ProcessCallback, void *)>("process_with_callback", &processWithCallback,
     ArgBuffer("data"), Arg("size"), Arg("callback"), ArgBuffer("user_data"));
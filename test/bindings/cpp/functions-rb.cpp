@@ -35,6 +35,9 @@ void Init_Functions()
   define_global_function<void(*)(int, float, double, int)>("mixed_params", &mixedParams,
     Arg("named"), Arg("arg_1"), Arg("also_named"), Arg("arg_3"));
 
+  define_global_function<double(*)(double, int, int)>("scale_value", &scaleValue,
+    Arg("value"), Arg("count"), Arg("i"));
+
   define_global_function<bool(*)()>("empty?", &isEmpty);
 
   define_global_function<bool(*)()>("valid?", &isValid);
@@ -63,7 +66,9 @@ void Init_Functions()
     .define_method<bool(Widget::*)(int)>("contains", &Widget::contains,
       Arg("x"))
     .define_method<bool(Widget::*)(int)>("try_set", &Widget::trySet,
-      Arg("value"));
+      Arg("value"))
+    .define_method<int(Widget::*)(int, int)>("scale", &Widget::scale,
+      Arg("self"), Arg("count"));
 
   Module rb_mArrays = define_module("Arrays");
 
@@ -0,0 +1,37 @@
+# encoding: UTF-8
+
+require_relative './rice_test_base'
+
+class BufferPairsTest < RiceAbstractTest
+  def test_pairs_by_parameter_name
+    parsed, = parse_cpp(<<~CPP)
+      void process(const float* data, unsigned long count, int flags);
+      void fill(int* first, int* last, int value);
+      void bytes(void* buffer, int bufferSize);
+      void mismatched(double* values, int flags);
+      void strings(const char* text, int length);
+    CPP
+
+    finder = RubyBindgen::Generators::Rice::BufferPairs.new
+    root = parsed.translation_unit.cursor
+
+    assert_equal [[0, 1, :length]], finder.find(find_cursor(root, :cursor_function, "process")).map(&:to_a)
+    assert_equal [[0, 1, :end]], finder.find(find_cursor(root, :cursor_function, "fill")).map(&:to_a)
+    assert_equal [[0, 1, :length]], finder.find(find_cursor(root, :cursor_function, "bytes")).map(&:to_a)
+    assert_empty finder.find(find_cursor(root, :cursor_function, "mismatched"))
+    assert_empty finder.find(find_cursor(root, :cursor_function, "strings"))
+  end
+
+  def test_explicit_pairs_ignore_names
+    parsed, = parse_cpp(<<~CPP)
+      void mismatched(double* values, int flags);
+      void range(const short* from, const short* to);
+    CPP
+
+    finder = RubyBindgen::Generators::Rice::BufferPairs.new
+    root = parsed.translation_unit.cursor
+
+    assert_equal [[0, 1, :length]], finder.find(find_cursor(root, :cursor_function, "mismatched"), explicit: true).map(&:to_a)
+    assert_equal [[0, 1, :end]], finder.find(find_cursor(root, :cursor_function, "range"), explicit: true).map(&:to_a)
+  end
+end
@@ -1,6 +1,7 @@
 # encoding: UTF-8
 
 require 'fileutils'
+require 'json'
 
 require_relative './abstract_test'
 
@@ -43,6 +44,133 @@ class CMakeTest < AbstractTest
                  "Only subdirectory CMakeLists.txt files should be generated without project"
   end
 
+  def test_cmake_modules
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir, 'cmake.yaml')
+    config[:modules] = { dnn: { paths: ["guards/dnn"] } }
+    outputter = create_outputter("cpp")
+    inputter = RubyBindgen::Inputter.new(outputter.base_path, config[:match] || ["**/*-rb.cpp"], config[:skip] || [])
+    generator = RubyBindgen::Generators::CMake.new(inputter, outputter, config)
+    generator.generate
+
+    root_cmake = generator.outputter.output_paths.fetch(generator.outputter.output_path("CMakeLists.txt"))
+    dnn_cmake = generator.outputter.output_paths.fetch(generator.outputter.output_path("guards/dnn/CMakeLists.txt"))
+    guards_cmake = generator.outputter.output_paths.fetch(generator.outputter.output_path("guards/CMakeLists.txt"))
+
+    assert_includes root_cmake, "add_library(${CMAKE_PROJECT_NAME}_dnn MODULE)"
+    assert_includes root_cmake, "CXX_VISIBILITY_PRESET default"
+    refute_includes root_cmake, "CXX_VISIBILITY_PRESET hidden"
+    assert_includes dnn_cmake, "target_sources(${CMAKE_PROJECT_NAME}_dnn PRIVATE"
+    assert_includes guards_cmake, "target_sources(${CMAKE_PROJECT_NAME} PRIVATE"
+  end
+
+  def test_cmake_modules_match_rice_modules
+    modules = { cuda: { paths: ["guards/cuda*.hpp"] }, dnn: { paths: ["guards/dnn"] } }
+
+    rice_dir = File.join(__dir__, "headers", "cpp")
+    rice_config = load_config(rice_dir)
+    rice_config[:match] = ["guards/base.hpp", "guards/cudaarithm.hpp", "guards/cudaimgproc.hpp", "guards/dnn/layer.hpp"]
+    rice_config[:project] = "test_project"
+    rice_config[:modules] = modules
+    rice_outputter = create_outputter("cpp")
+    rice = RubyBindgen::Generators::Rice.new(RubyBindgen::Inputter.new(rice_dir, rice_config[:match]), rice_outputter, rice_config)
+    capture_io { rice.generate }
+
+    config = load_config(rice_dir, 'cmake.yaml')
+    config[:modules] = modules
+    outputter = create_outputter("cpp")
+    inputter = RubyBindgen::Inputter.new(outputter.base_path, config[:match] || ["**/*-rb.cpp"], config[:skip] || [])
+    generator = RubyBindgen::Generators::CMake.new(inputter, outputter, config)
+    generator.generate
+
+    main_cpp = rice_outputter.output_paths.fetch(rice_outputter.output_path("test_project-rb.cpp"))
+    cuda_cpp = rice_outputter.output_paths.fetch(rice_outputter.output_path("test_project_cuda-rb.cpp"))
+    dnn_cpp = rice_outputter.output_paths.fetch(rice_outputter.output_path("test_project_dnn-rb.cpp"))
+    guards_cmake = outputter.output_paths.fetch(outputter.output_path("guards/CMakeLists.txt"))
+    dnn_cmake = outputter.output_paths.fetch(outputter.output_path("guards/dnn/CMakeLists.txt"))
+
+    # Each source is compiled into the target whose Init function runs it
+    assert_includes main_cpp, "Init_Base();"
+    assert_includes guards_cmake, "target_sources(${CMAKE_PROJECT_NAME} PRIVATE\n  \"base-rb.cpp\"\n)"
+    assert_includes cuda_cpp, "Init_Cudaarithm();"
+    assert_includes cuda_cpp, "Init_Cudaimgproc();"
+    assert_includes guards_cmake, "target_sources(${CMAKE_PROJECT_NAME}_cuda PRIVATE\n    \"cudaarithm-rb.cpp\"\n    \"cudaimgproc-rb.cpp\"\n  )"
+    assert_includes dnn_cpp, "Init_Dnn_Layer();"
+    assert_includes dnn_cmake, "target_sources(${CMAKE_PROJECT_NAME}_dnn PRIVATE"
+  end
+
+  def test_cmake_size_profile
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir, 'cmake.yaml')
+    config[:size_profile] = true
+    outputter = create_outputter("cpp")
+    inputter = RubyBindgen::Inputter.new(outputter.base_path, config[:match] || ["**/*-rb.cpp"], config[:skip] || [])
+    generator = RubyBindgen::Generators::CMake.new(inputter, outputter, config)
+    generator.generate
+
+    root_cmake = generator.outputter.output_paths.fetch(generator.outputter.output_path("CMakeLists.txt"))
+    presets = JSON.parse(generator.outputter.output_paths.fetch(generator.outputter.output_path("CMakePresets.json")))
+    version_script = generator.outputter.output_paths.fetch(generator.outputter.output_path("test_project.map"))
+
+    assert_includes root_cmake, "option(RUBY_BINDGEN_SIZE_PROFILE"
+    assert_includes root_cmake, "\"LINKER:--version-script=${CMAKE_CURRENT_SOURCE_DIR}/test_project.map\""
+    size_preset = presets["configurePresets"].find { |preset| preset["name"] == "linux-release-size" }
+    assert_equal "ON", size_preset["cacheVariables"]["RUBY_BINDGEN_SIZE_PROFILE"]
+    assert_includes version_script, "Init_test_project;"
+  end
+
+  def test_cmake_time_trace
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir, 'cmake.yaml')
+    config[:time_trace] = true
+    outputter = create_outputter("cpp")
+    inputter = RubyBindgen::Inputter.new(outputter.base_path, config[:match] || ["**/*-rb.cpp"], config[:skip] || [])
+    generator = RubyBindgen::Generators::CMake.new(inputter, outputter, config)
+    generator.generate
+
+    presets = JSON.parse(generator.outputter.output_paths.fetch(generator.outputter.output_path("CMakePresets.json")))
+    trace_preset = presets["configurePresets"].find { |preset| preset["name"] == "linux-time-trace" }
+    assert_equal "clang++", trace_preset["cacheVariables"]["CMAKE_CXX_COMPILER"]
+    assert_includes trace_preset["cacheVariables"]["CMAKE_CXX_FLAGS_RELEASE"], "-ftime-trace"
+    assert presets["buildPresets"].any? { |preset| preset["configurePreset"] == "macos-time-trace" }
+  end
+
+  def test_cmake_job_pools
+    require 'tmpdir'
+    Dir.mktmpdir do |dir|
+      FileUtils.mkdir_p(File.join(dir, "core"))
+      File.write(File.join(dir, "light-rb.cpp"), "")
+      File.write(File.join(dir, "core", "mat-rb.cpp"), "")
+      File.write(File.join(dir, "ruby-bindgen-manifest.json"), JSON.generate(
+        "files" => {
+          "light-rb.cpp" => { "classes" => 1, "methods" => 10, "constants" => 0, "instantiations" => 0 },
+          "core/mat-rb.cpp" => { "classes" => 40, "methods" => 2000, "constants" => 50, "instantiations" => 12 }
+        }))
+
+      config_dir = File.join(__dir__, "headers", "cpp")
+      config = load_config(config_dir, 'cmake.yaml')
+      config[:guards] = nil
+      config[:job_pools] = { heavy: 3, threshold: 1000 }
+
+      outputter = RubyBindgen::TestOutputter.new(dir)
+      inputter = RubyBindgen::Inputter.new(dir, ["**/*-rb.cpp"])
+      generator = RubyBindgen::Generators::CMake.new(inputter, outputter, config)
+      generator.generate
+
+      root_cmake = outputter.output_paths.fetch(outputter.output_path("CMakeLists.txt"))
+      core_cmake = outputter.output_paths.fetch(outputter.output_path("core/CMakeLists.txt"))
+
+      assert_includes root_cmake, "set(RUBY_BINDGEN_HEAVY_JOBS 3 CACHE STRING"
+      assert_includes root_cmake, "JOB_POOL_COMPILE heavy_compile"
+      assert_includes root_cmake, "target_compile_definitions(${RUBY_BINDGEN_TARGET}_heavy PRIVATE $<TARGET_PROPERTY:${RUBY_BINDGEN_TARGET},COMPILE_DEFINITIONS>)"
+      assert_includes root_cmake, "target_compile_features(${RUBY_BINDGEN_TARGET}_heavy PRIVATE $<TARGET_PROPERTY:${RUBY_BINDGEN_TARGET},COMPILE_FEATURES>)"
+      assert_includes root_cmake, "POSITION_INDEPENDENT_CODE ${RUBY_BINDGEN_PIC}"
+      assert_includes root_cmake, "target_sources(${CMAKE_PROJECT_NAME} PRIVATE\n  \"light-rb.cpp\""
+      assert_includes core_cmake, "set_property(GLOBAL APPEND PROPERTY RUBY_BINDGEN_HEAVY_SOURCES_${CMAKE_PROJECT_NAME}\n  \"${CMAKE_CURRENT_SOURCE_DIR}/mat-rb.cpp\""
+      refute_includes core_cmake, "target_sources"
+    end
+  end
+
   def test_cmake_overlapping_guards_raise
     require 'tmpdir'
     Dir.mktmpdir do |dir|
@@ -90,9 +90,83 @@ class FfiTest < AbstractTest
       })
   end
 
+  def test_array_views
+    config_dir = File.join(__dir__, "headers", "c")
+    config = load_config(config_dir)
+    config[:match] = ["structs.h"]
+    config[:project] = "structs"
+    config[:library_names] = ["structs"]
+    config[:library_versions] = []
+    config[:array_views] = true
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("c")
+    generator = RubyBindgen::Generators::FFI.new(inputter, outputter, config)
+    generator.generate
+
+    content = outputter.output_paths.fetch(outputter.output_path("structs.rb"))
+    assert_includes content, "    layout :data, [:ulong_long, 3]\n\n    def data\n      self[:data]\n    end"
+    assert_includes content, "raise ArgumentError, \"data expects 3 elements\" unless values.size == 3"
+    assert_includes content, "self[:data].to_ptr.put_array_of_ulong_long(0, values)"
+    # Fields named like an FFI::Struct method keep only Struct#[]
+    refute_includes content, "def size\n"
+    refute_includes content, "def values\n"
+    refute_includes content, "def values=(values)"
+    assert_includes content, "    def weights\n      self[:weights]\n    end"
+    assert_includes content, "self[:weights].to_ptr.put_array_of_double(0, values)"
+  end
+
+  def test_field_accessors
+    outputter = generate_ffi("structs.h", project: "structs",
+      library_names: ["structs"], library_versions: [], field_accessors: true)
+
+    content = outputter.output_paths.fetch(outputter.output_path("structs.rb"))
+
+    assert_includes content, "    OFFSET_OFFSET = offset_of(:offset)\n    DATA_TYPE_OFFSET = offset_of(:data_type)\n"
+    assert_includes content, "    def data_type\n      pointer.get_int(DATA_TYPE_OFFSET)\n    end"
+    assert_includes content, "    def data_type=(value)\n      pointer.put_int(DATA_TYPE_OFFSET, value)\n    end"
+    assert_includes content, "      pointer.get_ushort(US_OFFSET)"
+    assert_includes content, "      pointer.get_uchar(U8_OFFSET)"
+    # Unions, arrays and bools keep Struct#[]
+    refute_includes content, "def u\n"
+    refute_includes content, "def b\n"
+  end
+
+  def test_lazy_attach
+    outputter = generate_ffi("functions.h", project: "functions",
+      library_names: ["functions"], library_versions: [], lazy_attach: true)
+
+    content = outputter.output_paths.fetch(outputter.output_path("functions.rb"))
+    project = outputter.output_paths.fetch(outputter.output_path("functions_ffi.rb"))
+
+    assert_includes content, "  lazy_attach_function :add, :add, [:int, :int], :int"
+    assert_includes content, "  lazy_attach_function :my_printf, :my_printf, [:string, :varargs], :int"
+    refute_includes content, "  attach_function"
+
+    assert_includes project, "  def self.lazy_attach_function(name, function, parameter_types, return_type, **options)"
+    assert_includes project, "      attach_function(name, function, parameter_types, return_type, options)"
+    assert project.end_with?("require_relative 'functions'\n\nFunctions::LAZY_FUNCTIONS.freeze\n")
+  end
+
+  def test_blocking
+    outputter = generate_ffi("functions.h", project: "functions",
+      library_names: ["functions"], library_versions: [],
+      symbols: { blocking: ["add", "/^log_/"] })
+
+    content = outputter.output_paths.fetch(outputter.output_path("functions.rb"))
+
+    assert_includes content, "  # Blocking: releases the GVL while the C function runs\n  attach_function :add, :add, [:int, :int], :int, blocking: true\n"
+    assert_includes content, "  attach_function :log_message, :log_message, [:int, :string, :string, :varargs], :void, blocking: true\n"
+    assert_includes content, "  attach_function :my_printf, :my_printf, [:string, :varargs], :int\n"
+  end
+
   private
 
   def run_ffi_test(match, **overrides)
+    validate_result(generate_ffi(match, **overrides))
+  end
+
+  def generate_ffi(match, **overrides)
     config_dir = File.join(__dir__, "headers", "c")
     config = load_config(config_dir)
     config[:match] = Array(match)
@@ -102,6 +176,6 @@ class FfiTest < AbstractTest
     outputter = create_outputter("c")
     generator = RubyBindgen::Generators::FFI.new(inputter, outputter, config)
     generator.generate
-    validate_result(generator.outputter)
+    generator.outputter
   end
 end
@@ -31,4 +31,10 @@ typedef struct {
   short s;
   bool b;
   uint8_t u8;
-} TypeCoverageStruct;
\ No newline at end of file
+} TypeCoverageStruct;
+
+typedef struct {
+  float size[2];
+  int values[4];
+  double weights[2];
+} ArrayNamesStruct;
@@ -45,6 +45,7 @@ void processIntBuffer(int* data, int size);
 void processDoubleBuffer(double* values, int count);
 void processCharBuffer(char* buffer, int length);
 void processUnsignedBuffer(unsigned char* data, size_t size);
+int scaleIntBuffer(int* data, int count, int factor);
 
 // Const fundamental type pointers
 void readIntBuffer(const int* data, int size);
@@ -105,6 +106,9 @@ public:
 
     // Out parameter method
     void computeStats(double* mean, double* stddev);
+
+    // Parameters named like the receiver and a generated BufferView local
+    void mixSamples(const float* samples, int count, float samples_view, int self);
 };
 
 // =============================================================================
@@ -0,0 +1,35 @@
+#include <string>
+
+namespace bulk
+{
+  struct Sample
+  {
+    float x;
+    float y;
+  };
+
+  // Pointer iterators over a POD struct get to_a, to_packed and each_slice
+  class Samples
+  {
+  public:
+    Sample* begin();
+    Sample* end();
+    const Sample* begin() const;
+    const Sample* end() const;
+  };
+
+  class Levels
+  {
+  public:
+    unsigned short* begin();
+    unsigned short* end();
+  };
+
+  // std::string is not POD, so Names only gets each
+  class Names
+  {
+  public:
+    const std::string* begin() const;
+    const std::string* end() const;
+  };
+}
@@ -15,6 +15,9 @@ void processString(const char * const str, int len);
 void unnamedParams(int, float, double);
 void mixedParams(int named, float, double alsoNamed, int);
 
+// Parameters named like the locals of vectorized _many bindings
+double scaleValue(double value, int count, int i);
+
 // Test bool return type naming (Issue #37)
 // Predicate functions (no params) should get ? suffix
 // Action functions (with params) should NOT get ? suffix
@@ -36,6 +39,7 @@ public:
   bool isEnabled();         // -> enabled?
   bool contains(int x);     // -> contains (NOT contains?)
   bool trySet(int value);   // -> try_set (NOT try_set?)
+  int scale(int self, int count);
 };
 
 // =============================================================================
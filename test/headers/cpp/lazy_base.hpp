@@ -0,0 +1,12 @@
+// Class registered lazily and used from another file (see lazy_derived.hpp).
+
+namespace Lazy
+{
+  class Shape
+  {
+  public:
+    Shape() : size(1) {}
+    double area() const { return size * size; }
+    double size;
+  };
+}
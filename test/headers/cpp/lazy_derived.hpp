@@ -0,0 +1,15 @@
+// Lazy class whose base class and parameter type come from lazy_base.hpp.
+// Shape must be defined when the extension loads even though its methods
+// are registered later.
+
+#include "lazy_base.hpp"
+
+namespace Lazy
+{
+  class Circle : public Shape
+  {
+  public:
+    Circle() : Shape() {}
+    void copyFrom(const Shape& other) { size = other.size; }
+  };
+}
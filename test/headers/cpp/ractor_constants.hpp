@@ -0,0 +1,23 @@
+// Constants checked by ractor_safe. Enum values are wrapped Rice objects and
+// cannot be shared between Ractors.
+
+namespace Ractor
+{
+  enum class Mode
+  {
+    Fast,
+    Slow
+  };
+
+  const int DEFAULT_SIZE = 16;
+  const Mode DEFAULT_MODE = Mode::Fast;
+
+  // Strings are frozen. A null pointer must not be read, and an array must
+  // not be read past its end.
+  const char* const NAME = "ractor";
+  const char* const NO_NAME = nullptr;
+  const char LABEL[4] = {'a', 'b', 'c', 'd'};
+
+  // Byte tables are not text
+  const unsigned char LUT[4] = {1, 0, 3, 4};
+}
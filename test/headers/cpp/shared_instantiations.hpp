@@ -0,0 +1,17 @@
+// Class template specialized by typedefs in this header and in
+// shared_instantiations_user.hpp. With a project, Holder<int> should only be
+// instantiated by this header's bindings.
+
+namespace Shared
+{
+  template<typename T>
+  class Holder
+  {
+  public:
+    T value;
+    Holder() : value() {}
+    T get() const { return value; }
+  };
+
+  typedef Holder<int> HolderInt;
+}
@@ -0,0 +1,9 @@
+// A third specialization of Holder<int>, used to check that files in the
+// same module share one registration.
+
+#include "shared_instantiations.hpp"
+
+namespace Shared
+{
+  typedef Holder<int> OtherHolder;
+}
@@ -0,0 +1,10 @@
+// Re-specializes Holder<int> under a second name, plus a specialization that
+// only this header uses.
+
+#include "shared_instantiations.hpp"
+
+namespace Shared
+{
+  typedef Holder<int> IntHolder;
+  typedef Holder<double> HolderDouble;
+}
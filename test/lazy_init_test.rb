@@ -0,0 +1,165 @@
+# encoding: UTF-8
+
+require_relative './abstract_test'
+require 'open3'
+require 'rbconfig'
+require 'tmpdir'
+
+# Builds the LazyInit support header into a small Ruby extension and checks
+# how its stubs behave at runtime. The extension defines classes with the
+# plain Ruby C API, so only cpp_protect is needed from Rice.
+class LazyInitTest < AbstractTest
+  EXTENSION = <<~CPP
+    #include <ruby.h>
+    #include <stdexcept>
+
+    namespace Rice { namespace detail {
+      template<typename Function_T>
+      auto cpp_protect(Function_T func)
+      {
+        try
+        {
+          return func();
+        }
+        catch (std::exception& exception)
+        {
+          rb_raise(rb_eRuntimeError, "%s", exception.what());
+        }
+      }
+    }}
+
+    #include "rice_lazy_init.hpp"
+
+    static VALUE rb_cBase, rb_cDerived, rb_cAbstract, rb_cFlaky;
+    static int loads = 0;
+    static int failures = 1;
+
+    static VALUE base_initialize(int argc, VALUE* argv, VALUE self)
+    {
+      VALUE count = rb_iv_get(rb_cBase, "@initialized");
+      rb_iv_set(rb_cBase, "@initialized", INT2NUM(NIL_P(count) ? 1 : NUM2INT(count) + 1));
+      rb_iv_set(self, "@args", rb_ary_new_from_values(argc, argv));
+      if (rb_block_given_p())
+      {
+        rb_iv_set(self, "@block", rb_yield(Qnil));
+      }
+      return self;
+    }
+
+    static VALUE answer(VALUE)
+    {
+      return INT2NUM(42);
+    }
+
+    static VALUE loaded(VALUE)
+    {
+      return INT2NUM(loads);
+    }
+
+    extern "C" void Init_lazy_init_ext()
+    {
+      rb_define_module_function(rb_cObject, "lazy_loads", RUBY_METHOD_FUNC(loaded), 0);
+
+      rb_cBase = rb_define_class("Base", rb_cObject);
+      RubyBindgen::LazyInit::attach(rb_cBase, []()
+      {
+        loads++;
+        rb_define_method(rb_cBase, "initialize", RUBY_METHOD_FUNC(base_initialize), -1);
+        rb_define_method(rb_cBase, "answer", RUBY_METHOD_FUNC(answer), 0);
+      });
+
+      rb_cDerived = rb_define_class("Derived", rb_cBase);
+      RubyBindgen::LazyInit::attach(rb_cDerived, []()
+      {
+        loads++;
+        rb_define_method(rb_cDerived, "derived_answer", RUBY_METHOD_FUNC(answer), 0);
+      });
+
+      // No constructor, so Object#initialize is used once the class is loaded
+      rb_cAbstract = rb_define_class("Abstract", rb_cObject);
+      RubyBindgen::LazyInit::attach(rb_cAbstract, []()
+      {
+        rb_define_method(rb_cAbstract, "answer", RUBY_METHOD_FUNC(answer), 0);
+      });
+
+      rb_cFlaky = rb_define_class("Flaky", rb_cObject);
+      RubyBindgen::LazyInit::attach(rb_cFlaky, []()
+      {
+        if (failures-- > 0)
+        {
+          throw std::runtime_error("loader failed");
+        }
+        rb_define_method(rb_cFlaky, "answer", RUBY_METHOD_FUNC(answer), 0);
+      });
+    }
+  CPP
+
+  SCRIPT = <<~RUBY
+    require "minitest/autorun"
+    require "lazy_init_ext"
+
+    class LazyInitRuntime < Minitest::Test
+      def test_subclass_initialize_runs_once
+        subclass = Class.new(Derived) do
+          attr_reader :own
+          def initialize(*args, &block)
+            @own = (@own || 0) + 1
+            super
+          end
+        end
+
+        object = subclass.new(1, 2) { :block }
+        assert_equal 1, object.own
+        assert_equal 1, Base.instance_variable_get(:@initialized)
+        assert_equal [1, 2], object.instance_variable_get(:@args)
+        assert_equal :block, object.instance_variable_get(:@block)
+        assert_equal [42, 42], [object.answer, object.derived_answer]
+        assert_equal 2, lazy_loads
+
+        Derived.new(3)
+        assert_equal 2, Base.instance_variable_get(:@initialized)
+        assert_equal 2, lazy_loads
+      end
+
+      def test_class_without_constructor
+        assert_equal 42, Abstract.new.answer
+        assert_raises(ArgumentError) { Abstract.new(1) }
+      end
+
+      def test_failed_loader_restores_stubs
+        error = assert_raises(RuntimeError) { Flaky.new.answer }
+        assert_equal "loader failed", error.message
+        assert Flaky.new.respond_to?(:answer)
+        assert_equal 42, Flaky.new.answer
+      end
+    end
+  RUBY
+
+  def test_lazy_init_runtime
+    skip "Needs a Unix C++ toolchain" if RbConfig::CONFIG['arch'] =~ /mswin|mingw/
+
+    Dir.mktmpdir do |dir|
+      generator = RubyBindgen::Generators::Rice.new(nil, RubyBindgen::Outputter.new(dir), lazy: true)
+      File.write(File.join(dir, "rice_lazy_init.hpp"), generator.send(:render_template, "lazy_init.hpp"))
+
+      File.write(File.join(dir, "lazy_init_ext.cpp"), EXTENSION)
+      File.write(File.join(dir, "lazy_init_runtime.rb"), SCRIPT)
+
+      extension = File.join(dir, "lazy_init_ext.#{RbConfig::CONFIG['DLEXT']}")
+      output, status = Open3.capture2e(*compile_command(File.join(dir, "lazy_init_ext.cpp"), extension))
+      flunk "Compile errors:\n#{output}" unless status.success?
+
+      output, status = Open3.capture2e(RbConfig.ruby, "-I", dir, File.join(dir, "lazy_init_runtime.rb"))
+      assert status.success?, output
+    end
+  end
+
+  private
+
+  def compile_command(source, extension)
+    config = RbConfig::CONFIG
+    [*config['CXX'].split, "-std=c++17", "-shared", "-fPIC",
+     "-I#{config['rubyhdrdir']}", "-I#{config['rubyarchhdrdir']}",
+     source, "-o", extension, *config['DLDFLAGS'].split]
+  end
+end
@@ -0,0 +1,46 @@
+# encoding: UTF-8
+
+require_relative './rice_test_base'
+
+class OverloadIndexTest < RiceAbstractTest
+  def test_counts_overloads_per_class
+    parsed, = parse_cpp(<<~CPP)
+      class Widget {
+      public:
+        static Widget create(int size);
+        static Widget create(int width, int height);
+        template<typename T> static Widget wrap(T* value);
+        static Widget wrap(void* value);
+        int size() const;
+      };
+    CPP
+
+    index = RubyBindgen::Generators::Rice::OverloadIndex.new
+    root = parsed.translation_unit.cursor
+
+    assert index.overloaded?(find_cursor(root, :cursor_cxx_method, "create"))
+    assert index.overloaded?(find_cursor(root, :cursor_cxx_method, "wrap"))
+    refute index.overloaded?(find_cursor(root, :cursor_cxx_method, "size"))
+  end
+
+  def test_counts_overloads_across_namespace_blocks
+    parsed, = parse_cpp(<<~CPP)
+      namespace Outer {
+        void process(int value);
+        void single(int value);
+        void single(int value);
+      }
+
+      namespace Outer {
+        void process(double value);
+      }
+    CPP
+
+    index = RubyBindgen::Generators::Rice::OverloadIndex.new
+    root = parsed.translation_unit.cursor
+
+    assert_equal 2, index.count(find_cursor(root, :cursor_function, "process"))
+    # Redeclarations of one function are not overloads
+    assert_equal 1, index.count(find_cursor(root, :cursor_function, "single"))
+  end
+end
@@ -629,6 +629,644 @@ class RiceTest < AbstractTest
     end
   end
 
+  def test_minimal_stl_headers
+    require 'tmpdir'
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["vector_variant_attrs.hpp"]
+    config[:stl_headers] = "minimal"
+
+    Dir.mktmpdir do |dir|
+      inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+      outputter = RubyBindgen::TestOutputter.new(dir)
+      generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+      capture_io { generator.generate }
+
+      include_header = outputter.output_paths.fetch(outputter.output_path("rice_include.hpp"))
+
+      assert_includes include_header, "#include <rice/stl/string.hpp>"
+      assert_includes include_header, "#include <rice/stl/variant.hpp>"
+      assert_includes include_header, "#include <rice/stl/vector.hpp>"
+      refute_includes include_header, "#include <rice/stl/map.hpp>"
+      # Rice installs without every per-type header fall back to the combined header
+      assert_includes include_header, "#if __has_include(<rice/stl/exception.hpp>) && \\\n    __has_include(<rice/stl/string.hpp>) && \\\n"
+      assert_includes include_header, "    __has_include(<rice/stl/vector.hpp>)\n#include <rice/stl/exception.hpp>"
+      assert_includes include_header, "#else\n#include <rice/stl.hpp>\n#endif"
+
+      # An existing include header keeps the user's edits
+      File.write(File.join(dir, "rice_include.hpp"), include_header)
+      outputter = RubyBindgen::TestOutputter.new(dir)
+      generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+      capture_io { generator.generate }
+      refute outputter.output_paths.key?(outputter.output_path("rice_include.hpp"))
+    end
+  end
+
+  def test_extern_templates
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["cross_file_base.hpp", "cross_file_derived.hpp"]
+    config[:extern_templates] = true
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    generated_cpp = outputter.output_paths.fetch(outputter.output_path("cross_file_derived-rb.cpp"))
+    generated_ipp = outputter.output_paths.fetch(outputter.output_path("cross_file_derived-rb.ipp"))
+    instantiations_cpp = outputter.output_paths.fetch(outputter.output_path("cross_file_derived_instantiations-rb.cpp"))
+
+    declaration = "template Rice::Data_Type<CrossFile::DerivedVector<double, 4>> DerivedVector_instantiate<double, 4>(Rice::Module parent, const char* name);"
+    assert_includes generated_cpp, "extern #{declaration}"
+    assert_includes generated_cpp, "DerivedVector_instantiate<double, 4>(rb_mCrossFile, \"DerivedVector4d\")"
+    refute_includes generated_ipp, "inline Rice::Data_Type"
+
+    assert_includes instantiations_cpp, "#include <cross_file_derived.hpp>"
+    assert_includes instantiations_cpp, "#include \"cross_file_derived-rb.ipp\""
+    assert_includes instantiations_cpp, declaration
+    refute_includes instantiations_cpp, "extern #{declaration}"
+  end
+
+  def test_manifest
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["classes.hpp"]
+    config[:manifest] = true
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    manifest = JSON.parse(outputter.output_paths.fetch(outputter.output_path("ruby-bindgen-manifest.json")))
+    entry = manifest.fetch("files").fetch("classes-rb.cpp")
+
+    assert_equal "classes.hpp", entry["header"]
+    assert_equal "Init_Classes", entry["init"]
+    assert_operator entry["classes"], :>, 0
+    assert_operator entry["methods"], :>, entry["classes"]
+    assert_includes entry["types"], "Outer::MyClass"
+  end
+
+  def test_signatures_overloaded
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["overloads.hpp"]
+    config[:signatures] = "overloaded"
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    generated_cpp = outputter.output_paths.fetch(outputter.output_path("overloads-rb.cpp"))
+
+    # Not overloaded: Rice deduces the signature
+    assert_includes generated_cpp, ".define_method(\"finish\", &Outer::Inner::Queue::finish)"
+    # Overloaded methods, static functions (including a template overload) and free functions keep it
+    assert_includes generated_cpp, ".define_method<Outer::Inner::ExecutionContext(Outer::Inner::ExecutionContext::*)() const>(\"clone_with_new_queue\""
+    assert_includes generated_cpp, ".define_singleton_function<Outer::Inner::KernelArg(*)(const char *)>(\"constant\""
+    assert_includes generated_cpp, "rb_mOuterInner.define_module_function<void(*)(const Outer::Inner::ParallelBackend &)>(\"set_parallel_for_backend\""
+  end
+
+  def test_fast_path
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["classes.hpp"]
+    config[:symbols] = { fast_path: ["Outer::MyClass::methodTwo", "Outer::MyClass::staticMethodOne", "Outer::MyClass::overloaded"] }
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    _, err = capture_io { generator.generate }
+
+    generated_cpp = outputter.output_paths.fetch(outputter.output_path("classes-rb.cpp"))
+
+    assert_includes generated_cpp, "VALUE fast_path_OuterMyClass_method_two(VALUE self, VALUE arg0, VALUE arg1)"
+    assert_includes generated_cpp, "receiver->methodTwo(Rice::detail::From_Ruby<int>().convert(arg0), Rice::detail::From_Ruby<bool>().convert(arg1));"
+    assert_includes generated_cpp, "rb_define_method(rb_cOuterMyClass.value(), \"method_two\", RUBY_METHOD_FUNC(fast_path_OuterMyClass_method_two), 2);"
+    assert_includes generated_cpp, "rb_define_singleton_method(rb_cOuterMyClass.value(), \"static_method_one?\", RUBY_METHOD_FUNC(fast_path_OuterMyClass_static_method_one_3f), 0);"
+    refute_includes generated_cpp, "\"method_two\", &Outer::MyClass::methodTwo"
+
+    # Overloaded methods keep the Rice binding
+    assert_includes err, "fast_path ignored for Outer::MyClass::overloaded"
+    assert_includes generated_cpp, ".define_method<void(Outer::MyClass::*)(int)>(\"overloaded\""
+  end
+
+  def test_no_gvl
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["buffers.hpp"]
+    config[:symbols] = { no_gvl: ["DataProcessor::computeStats", "/^EventHandler::/"] }
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    _, err = capture_io { generator.generate }
+
+    generated_cpp = outputter.output_paths.fetch(outputter.output_path("buffers-rb.cpp"))
+
+    assert_includes generated_cpp, "ArgBuffer(\"mean\"), ArgBuffer(\"stddev\"), NoGVL());"
+    # Callbacks run Ruby code, so these keep the GVL
+    assert_includes generated_cpp, "Arg(\"validate\"));"
+    assert_includes err, "no_gvl ignored for EventHandler::setValidator"
+  end
+
+  def test_cold_init
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["templates.hpp"]
+    config[:cold_init] = true
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    generated_hpp = outputter.output_paths.fetch(outputter.output_path("templates-rb.hpp"))
+    generated_cpp = outputter.output_paths.fetch(outputter.output_path("templates-rb.cpp"))
+    generated_ipp = outputter.output_paths.fetch(outputter.output_path("templates-rb.ipp"))
+
+    assert_includes generated_hpp, "#define RUBY_BINDGEN_COLD __attribute__((cold))"
+    assert_includes generated_cpp, "RUBY_BINDGEN_COLD void Init_Templates()"
+    assert_includes generated_ipp, "RUBY_BINDGEN_COLD inline Rice::Data_Type<"
+  end
+
+  def test_profile_init
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["unions.hpp"]
+    config[:project] = "myproject"
+    config[:profile_init] = true
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp_project")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    project_cpp = outputter.output_paths.fetch(outputter.output_path("myproject-rb.cpp"))
+    assert_includes project_cpp, "std::getenv(\"RUBY_BINDGEN_PROFILE_INIT\")"
+    assert_match(/\{"Init_Unions", Init_Unions, [1-9]\d*, [1-9]\d*, \d+\},/, project_cpp)
+    assert_includes project_cpp, "run_init_functions(\"Init_myproject\", init_functions, std::size(init_functions));"
+  end
+
+  def test_ractor_safe
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["classes.hpp"]
+    config[:project] = "myproject"
+    config[:ractor_safe] = true
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp_project")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    _, err = capture_io { generator.generate }
+
+    project_cpp = outputter.output_paths.fetch(outputter.output_path("myproject-rb.cpp"))
+    generated_cpp = outputter.output_paths.fetch(outputter.output_path("classes-rb.cpp"))
+
+    assert_includes project_cpp, "rb_ext_ractor_safe(true);"
+    assert_includes generated_cpp, "define_constant(\"GLOBAL_CONSTANT\", GLOBAL_CONSTANT);"
+    assert_includes generated_cpp, "define_constant(\"SOME_CONSTANT\", Outer::MyClass::SOME_CONSTANT)"
+    refute_includes generated_cpp, "globalVariable"
+    refute_includes generated_cpp, "static_field_one"
+    assert_includes err, "ractor_safe skips globalVariable: mutable global variable"
+    assert_includes err, "ractor_safe skips Outer::MyClass::static_field_one: mutable static member"
+
+    config[:lazy] = true
+    error = assert_raises(ArgumentError) { RubyBindgen::Generators::Rice.new(inputter, outputter, config) }
+    assert_equal "ractor_safe cannot be combined with lazy", error.message
+  end
+
+  def test_ractor_safe_enum_constants
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["ractor_constants.hpp"]
+    config[:project] = "myproject"
+    config[:ractor_safe] = true
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp_project")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    _, err = capture_io { generator.generate }
+
+    generated_cpp = outputter.output_paths.fetch(outputter.output_path("ractor_constants-rb.cpp"))
+
+    assert_includes generated_cpp, "define_constant(\"DEFAULT_SIZE\", Ractor::DEFAULT_SIZE)"
+    refute_includes generated_cpp, "DEFAULT_MODE"
+    # Named enums stay registered, without their unshareable value constants
+    assert_includes generated_cpp, "define_enum_under<Ractor::Mode>(\"Mode\", rb_mRactor);"
+    refute_includes generated_cpp, "define_value"
+    assert_includes err, "ractor_safe skips values of Ractor::Mode: enum values are not shareable between Ractors"
+
+    assert_includes generated_cpp, "define_constant(\"NO_NAME\", Ractor::NO_NAME ? Rice::Object(rb_obj_freeze(rb_str_new_cstr(Ractor::NO_NAME))) : Rice::Object(Qnil))"
+    assert_includes generated_cpp, "define_constant(\"LABEL\", Rice::Object(rb_obj_freeze(rb_str_new(Ractor::LABEL, strnlen(Ractor::LABEL, sizeof(Ractor::LABEL))))))"
+    refute_includes generated_cpp, "Ractor::LUT"
+    assert_match(/ractor_safe skips Ractor::LUT: constant of type const unsigned char\[4\] is not shareable between Ractors/, err)
+    assert_match(/ractor_safe skips Ractor::DEFAULT_MODE: constant of type const (Ractor::)?Mode is not shareable between Ractors/, err)
+  end
+
+  def test_buffer_pairs
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["buffers.hpp"]
+    config[:buffer_pairs] = true
+    config[:symbols] = { buffer_pairs: ["createIntBuffer"] }
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    _, err = capture_io { generator.generate }
+
+    generated_cpp = outputter.output_paths.fetch(outputter.output_path("buffers-rb.cpp"))
+    header = outputter.output_paths.fetch(outputter.output_path("rice_buffer_view.hpp"))
+
+    assert_includes generated_cpp, "#include \"rice_buffer_view.hpp\""
+    assert_includes generated_cpp, "define_global_function(\"process_int_buffer\", [](Rice::Object data) -> decltype(auto)"
+    assert_includes generated_cpp, "RubyBindgen::BufferView<int> data_view(data.value());"
+    assert_includes generated_cpp, "  processIntBuffer(data_view.data(), data_view.length<int>());\n  data_view.commit();\n}"
+    assert_includes generated_cpp, "  decltype(auto) rb_result_ = scaleIntBuffer(data_view.data(), data_view.length<int>(), factor);\n  data_view.commit();\n  return rb_result_;"
+    assert_includes generated_cpp, "return getMinMax(input_view.data(), input_view.length<int>(), minVal, maxVal);"
+    assert_includes generated_cpp, "Arg(\"input\"), ArgBuffer(\"min_val\"), ArgBuffer(\"max_val\"))"
+    assert_includes generated_cpp, "define_method(\"set_data\", [](DataProcessor& self, Rice::Object data) -> decltype(auto)"
+    # Parameters named self or <name>_view do not shadow the receiver or the view
+    assert_includes generated_cpp, "[](DataProcessor& self, Rice::Object samples, float samples_view_, int self_) -> decltype(auto)"
+    assert_includes generated_cpp, "return self.mixSamples(samples_view.data(), samples_view.length<int>(), samples_view_, self_);"
+    assert_includes generated_cpp, "Arg(\"samples\"), Arg(\"samples_view\"), Arg(\"self\"))"
+    # char* is a string and T** an array of buffers, so neither is paired
+    assert_includes generated_cpp, "&processCharBuffer"
+    assert_includes generated_cpp, "&processIntArrays"
+    assert_includes header, "class BufferView"
+    assert_includes err, "buffer_pairs ignored for createIntBuffer"
+  end
+
+  def test_vectorize
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["functions.hpp", "operators.hpp"]
+    config[:symbols] = { vectorize: ["someFunction", "unnamedParams", "scaleValue", "Widget::scale", "overload", "Operators::operator()"] }
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    _, err = capture_io { generator.generate }
+
+    functions_cpp = outputter.output_paths.fetch(outputter.output_path("functions-rb.cpp"))
+    operators_cpp = outputter.output_paths.fetch(outputter.output_path("operators-rb.cpp"))
+
+    # The scalar binding is kept alongside the _many variant
+    assert_includes functions_cpp, "define_global_function<void(*)(float)>(\"some_function\", &someFunction"
+    assert_includes functions_cpp, "define_global_function(\"some_function_many\", [](Rice::Object a) -> void"
+    assert_includes functions_cpp, "RubyBindgen::BufferView<const float> arg_1_view(arg_1.value());"
+    assert_includes functions_cpp, "unnamedParams(arg_0_view.data()[rb_i_], arg_1_view.data()[rb_i_], arg_2_view.data()[rb_i_]);"
+
+    # Parameters named like the generated locals or the receiver keep working
+    assert_includes functions_cpp, "define_global_function(\"scale_value_many\", [](Rice::Object value, Rice::Object count, Rice::Object i) -> Rice::Object"
+    assert_includes functions_cpp, "double rb_value_ = scaleValue(value_view.data()[rb_i_], count_view.data()[rb_i_], i_view.data()[rb_i_]);"
+    assert_includes functions_cpp, "define_method(\"scale_many\", [](Widget& self, Rice::Object self_, Rice::Object count) -> Rice::Object"
+    assert_includes functions_cpp, "int rb_value_ = self.scale(self__view.data()[rb_i_], count_view.data()[rb_i_]);"
+    assert_includes functions_cpp, "Arg(\"self\"), Arg(\"count\"))"
+
+    assert_includes operators_cpp, "define_method(\"call_many\", [](Operators& self, Rice::Object a, Rice::Object b) -> Rice::Object"
+    assert_includes operators_cpp, "if (rb_count_ > static_cast<size_t>(std::numeric_limits<long>::max()) / sizeof(int))"
+    assert_includes operators_cpp, "VALUE rb_result_ = Rice::detail::protect(rb_str_new, static_cast<const char*>(nullptr), static_cast<long>(rb_count_ * sizeof(int)));"
+    assert_includes operators_cpp, "int rb_value_ = self.operator()(a_view.data()[rb_i_], b_view.data()[rb_i_]);"
+    assert_includes operators_cpp, "std::memcpy(rb_output_ + rb_i_ * sizeof(int), &rb_value_, sizeof(int));"
+
+    assert_includes err, "vectorize ignored for overload: overloaded callables would share one `_many` name"
+  end
+
+  def test_disambiguate_overloads
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["classes.hpp", "functions.hpp"]
+    config[:symbols] = { disambiguate_overloads: ["Outer::MyClass::overloaded", "overload", "someFunction"] }
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    classes_cpp = outputter.output_paths.fetch(outputter.output_path("classes-rb.cpp"))
+    functions_cpp = outputter.output_paths.fetch(outputter.output_path("functions-rb.cpp"))
+
+    # The dispatching name is kept alongside one name per overload
+    assert_includes classes_cpp, ".define_method<void(Outer::MyClass::*)(int)>(\"overloaded\", &Outer::MyClass::overloaded,"
+    assert_includes classes_cpp, ".define_method<void(Outer::MyClass::*)(int)>(\"overloaded_int\", &Outer::MyClass::overloaded,"
+    assert_includes classes_cpp, ".define_method<void(Outer::MyClass::*)(bool)>(\"overloaded_bool\", &Outer::MyClass::overloaded,"
+
+    assert_includes functions_cpp, "define_global_function<void(*)(int, int)>(\"overload_int_int\", static_cast<void(*)(int, int)>(&overload),"
+    assert_includes functions_cpp, "define_global_function<void(*)(int, int, int)>(\"overload_int_int_int\", static_cast<void(*)(int, int, int)>(&overload),"
+
+    # Functions that are not overloaded keep their single name
+    refute_includes functions_cpp, "\"some_function_float\""
+  end
+
+  def test_bulk_iterators
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["bulk_iterators.hpp"]
+    config[:bulk_iterators] = true
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    generated_cpp = outputter.output_paths.fetch(outputter.output_path("bulk_iterators-rb.cpp"))
+
+    # Samples has begin() and begin() const, so it gets one set from the const overload
+    assert_includes generated_cpp, ".define_method(\"to_a\", [](const bulk::Samples& self) -> Rice::Array"
+    assert_includes generated_cpp, "rb_ary_push(result, Rice::detail::To_Ruby<bulk::Sample>().convert(*iter));"
+    assert_includes generated_cpp, ".define_method(\"to_packed\", [](const bulk::Samples& self) -> Rice::String"
+    refute_includes generated_cpp, "[](bulk::Samples& self)"
+    assert_includes generated_cpp, ".define_method(\"each_slice\", [](bulk::Levels& self, size_t size) -> Rice::Object"
+    assert_includes generated_cpp, "return receiver.call(\"enum_for\", Rice::Symbol(\"each_slice\"), size);"
+    assert_includes generated_cpp, "VALUE result = Rice::detail::protect(rb_str_new, static_cast<const char*>(nullptr), static_cast<long>(count * sizeof(unsigned short)));"
+    assert_includes generated_cpp, "std::memcpy(output, &value, sizeof(unsigned short));"
+    refute_includes generated_cpp, "reinterpret_cast<unsigned short*>(RSTRING_PTR(result))"
+    assert_includes generated_cpp, "#include <cstring>"
+    refute_includes generated_cpp, "[](const bulk::Names& self)"
+    assert_equal 2, generated_cpp.scan("\"to_a\"").size
+  end
+
+  def test_field_references
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["vector_variant_attrs.hpp", "reference_fields.hpp"]
+    config[:field_references] = true
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    vector_cpp = outputter.output_paths.fetch(outputter.output_path("vector_variant_attrs-rb.cpp"))
+    reference_cpp = outputter.output_paths.fetch(outputter.output_path("reference_fields-rb.cpp"))
+
+    assert_includes vector_cpp, ".define_method(\"numbers\", [](Tests::VariantVectorHolder& self) -> std::vector<int>&"
+    assert_includes vector_cpp, "}, Return().keepAlive())"
+    assert_includes vector_cpp, ".define_method(\"numbers=\", [](Tests::VariantVectorHolder& self, const std::vector<int>& value) -> void"
+    assert_includes vector_cpp, "self.numbers = value;"
+    refute_includes vector_cpp, "define_attr(\"numbers\""
+
+    # Fundamental members keep define_attr
+    assert_includes reference_cpp, ".define_attr(\"value\", &Tests::ReferenceField::value)"
+  end
+
+  def test_array_views
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["classes.hpp"]
+    config[:array_views] = true
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    content = outputter.output_paths.fetch(outputter.output_path("classes-rb.cpp"))
+    assert_includes content, ".define_method(\"array_field\", [](Outer::AttributeTest& self) -> Rice::Buffer<int>"
+    assert_includes content, "return Rice::Buffer<int>(self.array_field, 3);"
+    assert_includes content, ".define_method(\"array_field=\", [](Outer::AttributeTest& self, Rice::Object values) -> void"
+    assert_includes content, "RubyBindgen::BufferView<const int> values_view(values.value());"
+    assert_includes content, "#include \"rice_buffer_view.hpp\""
+    refute_includes content, "define_attr(\"array_field\""
+  end
+
+  def test_memory_view
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["buffers.hpp"]
+    config[:memory_view] = {
+      DataProcessor: { data: "self.getWeights()", type: "double", shape: ["4"], readonly: true },
+      Missing: { data: "self.data()", format: "\"C\"", item_size: 1, shape: ["self.size()"] }
+    }
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    _, err = capture_io { generator.generate }
+
+    generated_cpp = outputter.output_paths.fetch(outputter.output_path("buffers-rb.cpp"))
+    header = outputter.output_paths.fetch(outputter.output_path("rice_memory_view.hpp"))
+
+    assert_includes generated_cpp, "#include \"rice_memory_view.hpp\""
+    assert_includes generated_cpp, "void memory_view_DataProcessor(VALUE value, RubyBindgen::MemoryView::Layout& layout)"
+    assert_includes generated_cpp, "layout.data = const_cast<void*>(static_cast<const void*>(self.getWeights()));"
+    assert_includes generated_cpp, "layout.format = RubyBindgen::MemoryView::format<double>();"
+    assert_includes generated_cpp, "layout.readonly = true;"
+    assert_includes generated_cpp, "RubyBindgen::MemoryView::define<memory_view_DataProcessor>(rb_cDataProcessor.value());"
+    assert_includes header, "rb_memory_view_register(klass, &entry);"
+    assert_includes err, "memory_view class not found: Missing"
+
+    config[:memory_view] = { DataProcessor: { data: "self.getData()", shape: ["4"] } }
+    error = assert_raises(ArgumentError) { RubyBindgen::Generators::Rice.new(inputter, outputter, config) }
+    assert_equal "memory_view DataProcessor requires either type or format", error.message
+  end
+
+  def test_modules
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["guards/base.hpp", "guards/cudaarithm.hpp", "guards/dnn/layer.hpp"]
+    config[:project] = "myproject"
+    config[:modules] = {
+      cuda: { paths: ["guards/cuda*.hpp"] },
+      dnn: { paths: ["guards/dnn"], depends: ["cuda"] }
+    }
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    main_cpp = outputter.output_paths.fetch(outputter.output_path("myproject-rb.cpp"))
+    cuda_cpp = outputter.output_paths.fetch(outputter.output_path("myproject_cuda-rb.cpp"))
+    dnn_cpp = outputter.output_paths.fetch(outputter.output_path("myproject_dnn-rb.cpp"))
+
+    assert_includes main_cpp, "rb_require(\"myproject_cuda\");"
+    assert_includes main_cpp, "rb_require(\"myproject_dnn\");"
+    assert_includes main_cpp, "Init_Base();"
+    refute_includes main_cpp, "Init_Cudaarithm();"
+
+    assert_includes cuda_cpp, "void Init_myproject_cuda()"
+    assert_includes cuda_cpp, "Init_Cudaarithm();"
+    refute_includes cuda_cpp, "rb_require"
+
+    assert_includes dnn_cpp, "rb_require(\"myproject_cuda\");"
+    assert_includes dnn_cpp, "Init_Dnn_Layer();"
+  end
+
+  def test_modules_dependency_cycle_raises
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:project] = "myproject"
+    config[:modules] = {
+      core: { paths: ["core"], depends: ["dnn"] },
+      dnn: { paths: ["dnn"], depends: ["core"] }
+    }
+
+    error = assert_raises(ArgumentError) do
+      RubyBindgen::Generators::Rice.new(nil, create_outputter("cpp"), config)
+    end
+    assert_match(/module dependency cycle/, error.message)
+  end
+
+  def test_lazy_registration
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["classes.hpp"]
+    config[:lazy] = true
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    generated_cpp = outputter.output_paths.fetch(outputter.output_path("classes-rb.cpp"))
+    lazy_init_hpp = outputter.output_paths.fetch(outputter.output_path("rice_lazy_init.hpp"))
+
+    assert_includes generated_cpp, "#include \"rice_lazy_init.hpp\""
+    assert_includes generated_cpp, "define_class_under<Outer::MyClass, Outer::BaseClass>(rb_mOuter, \"MyClass\");"
+    assert_includes generated_cpp, "RubyBindgen::LazyInit::attach(rb_cOuterMyClass, []()"
+    assert_includes generated_cpp, "    .define_method<void(Outer::MyClass::*)(int)>(\"method_one\", &Outer::MyClass::methodOne,"
+    assert_includes lazy_init_hpp, "class LazyInit"
+  end
+
+  def test_lazy_registration_across_files
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["lazy_base.hpp", "lazy_derived.hpp"]
+    config[:lazy] = true
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    base_cpp = outputter.output_paths.fetch(outputter.output_path("lazy_base-rb.cpp"))
+    derived_cpp = outputter.output_paths.fetch(outputter.output_path("lazy_derived-rb.cpp"))
+
+    # Shape is defined in Init_LazyBase, outside its loader, so Circle can
+    # name it as a base class and parameter type before Shape is first used
+    define_shape = base_cpp.index("Rice::Data_Type<Lazy::Shape> rb_cLazyShape = define_class_under<Lazy::Shape>(rb_mLazy, \"Shape\");")
+    attach_shape = base_cpp.index("RubyBindgen::LazyInit::attach(rb_cLazyShape, []()")
+    refute_nil define_shape
+    refute_nil attach_shape
+    assert_operator define_shape, :<, attach_shape
+    assert_operator base_cpp.index(".define_method<double(Lazy::Shape::*)() const>(\"area\", &Lazy::Shape::area)"), :>, attach_shape
+
+    define_circle = derived_cpp.index("Rice::Data_Type<Lazy::Circle> rb_cLazyCircle = define_class_under<Lazy::Circle, Lazy::Shape>(rb_mLazy, \"Circle\");")
+    attach_circle = derived_cpp.index("RubyBindgen::LazyInit::attach(rb_cLazyCircle, []()")
+    refute_nil define_circle
+    refute_nil attach_circle
+    assert_operator define_circle, :<, attach_circle
+    assert_operator derived_cpp.index(".define_method<void(Lazy::Circle::*)(const Lazy::Shape &)>(\"copy_from\", &Lazy::Circle::copyFrom,"), :>, attach_circle
+  end
+
+  def test_project_shares_template_specializations
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["shared_instantiations.hpp", "shared_instantiations_user.hpp"]
+    config[:project] = "myproject"
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    base_cpp = outputter.output_paths.fetch(outputter.output_path("shared_instantiations-rb.cpp"))
+    user_cpp = outputter.output_paths.fetch(outputter.output_path("shared_instantiations_user-rb.cpp"))
+
+    assert_includes base_cpp, "Holder_instantiate<int>(rb_mShared, \"HolderInt\")"
+    refute_includes user_cpp, "Holder_instantiate<int>"
+    assert_includes user_cpp, "// Shared::Holder<int> is registered by Init_SharedInstantiations"
+    assert_includes user_cpp, "rb_mShared.const_set_maybe(\"IntHolder\", rb_cIntHolder);"
+    assert_includes user_cpp, "Holder_instantiate<double>(rb_mShared, \"HolderDouble\")"
+  end
+
+  def test_shared_instantiations_per_module
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["shared_instantiations.hpp", "shared_instantiations_other.hpp", "shared_instantiations_user.hpp"]
+    config[:project] = "myproject"
+    config[:modules] = { user: { paths: ["shared_instantiations_other.hpp", "shared_instantiations_user.hpp"] } }
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    base_cpp = outputter.output_paths.fetch(outputter.output_path("shared_instantiations-rb.cpp"))
+    other_cpp = outputter.output_paths.fetch(outputter.output_path("shared_instantiations_other-rb.cpp"))
+    user_cpp = outputter.output_paths.fetch(outputter.output_path("shared_instantiations_user-rb.cpp"))
+
+    # The main extension loads the user module first, so the module
+    # registers Holder<int> once and the main extension reuses it even though
+    # its file is listed first
+    assert_includes other_cpp, "Holder_instantiate<int>(rb_mShared, \"OtherHolder\")"
+    refute_includes user_cpp, "Holder_instantiate<int>"
+    assert_includes user_cpp, "// Shared::Holder<int> is registered by Init_SharedInstantiationsOther"
+    refute_includes base_cpp, "Holder_instantiate<int>"
+    assert_includes base_cpp, "// Shared::Holder<int> is registered by Init_SharedInstantiationsOther"
+    assert_includes base_cpp, "rb_mShared.const_set_maybe(\"HolderInt\", rb_cHolderInt);"
+  end
+
+  def test_shared_instantiations_with_guarded_owner
+    config_dir = File.join(__dir__, "headers", "cpp")
+    config = load_config(config_dir)
+    config[:match] = ["shared_instantiations.hpp", "shared_instantiations_user.hpp"]
+    config[:project] = "myproject"
+    config[:version_check] = "TEST_VERSION"
+    config[:symbols] = { versions: { 20000 => ["Shared::HolderInt"] } }
+
+    inputter = RubyBindgen::Inputter.new(config_dir, config[:match])
+    outputter = create_outputter("cpp")
+    generator = RubyBindgen::Generators::Rice.new(inputter, outputter, config)
+
+    capture_io { generator.generate }
+
+    base_cpp = outputter.output_paths.fetch(outputter.output_path("shared_instantiations-rb.cpp"))
+    user_cpp = outputter.output_paths.fetch(outputter.output_path("shared_instantiations_user-rb.cpp"))
+
+    # HolderInt only registers Holder<int> from version 20000 on, so the
+    # unguarded IntHolder registers it itself below that version
+    assert_includes base_cpp, "Holder_instantiate<int>(rb_mShared, \"HolderInt\")"
+    fallback = user_cpp.index("#if TEST_VERSION < 20000")
+    registration = user_cpp.index("Holder_instantiate<int>(rb_mShared, \"IntHolder\")")
+    reference = user_cpp.index("// Shared::Holder<int> is registered by Init_SharedInstantiations")
+    refute_nil fallback
+    refute_nil registration
+    refute_nil reference
+    assert_operator fallback, :<, registration
+    assert_operator registration, :<, user_cpp.index("#else", fallback)
+    assert_operator user_cpp.index("#else", fallback), :<, reference
+    assert_operator reference, :<, user_cpp.index("#endif", fallback)
+  end
+
   def test_implicit_default_constructor_is_skipped_for_reference_members
     config_dir = File.join(__dir__, "headers", "cpp")
     config = load_config(config_dir)
@@ -77,6 +77,25 @@ class SymbolsTest < RiceAbstractTest
     assert_equal "[:int], :bool", symbols.override(cursor)
   end
 
+  def test_flag_is_not_hidden_by_other_entries
+    parsed, = parse_cpp(<<~CPP)
+      namespace Outer {
+        int rows();
+        int cols();
+      }
+    CPP
+
+    symbols = RubyBindgen::Symbols.new(versions: { 40000 => ["Outer::rows"] },
+                                       fast_path: ["/^Outer::/"])
+
+    rows = find_cursor(parsed.translation_unit.cursor, :cursor_function, "rows")
+    cols = find_cursor(parsed.translation_unit.cursor, :cursor_function, "cols")
+
+    assert symbols.flag?(rows, :fast_path), "exact versions entry should not hide the fast_path regex"
+    assert symbols.flag?(cols, :fast_path)
+    refute RubyBindgen::Symbols.new.flag?(cols, :fast_path)
+  end
+
   def test_skip_spelling_fallback_for_dependent_types
     # skip_spelling? is the fallback for types that have no declaration cursor
     # (dependent / unexposed types), so we test the bare API rather than a real
@@ -0,0 +1,53 @@
+# encoding: UTF-8
+
+require_relative './abstract_test'
+require 'json'
+require 'tmpdir'
+
+class TraceReportTest < AbstractTest
+  def test_attributes_compile_time_to_files_and_types
+    Dir.mktmpdir do |dir|
+      File.write(File.join(dir, "ruby-bindgen-manifest.json"), JSON.generate(
+        "files" => {
+          "core/mat-rb.cpp" => { "types" => ["cv::Mat", "cv::Mat_<float>"] },
+          "point-rb.cpp" => { "types" => ["cv::Point"] }
+        }))
+
+      object_dir = File.join(dir, "build", "CMakeFiles", "test_project.dir")
+      FileUtils.mkdir_p(File.join(object_dir, "core"))
+      # The Mat_ instantiation (3s) includes a nested cv::Mat instantiation (1s),
+      # which is charged to cv::Mat, not cv::Mat_.
+      write_trace(File.join(object_dir, "core", "mat-rb.cpp.json"), 10_000_000,
+                  ["InstantiateFunction", 1_000_000, 3_000_000, "Rice::Data_Type<cv::Mat_<float>>::define_method<void (cv::Mat_<float>::*)()>"],
+                  ["InstantiateFunction", 1_500_000, 1_000_000, "cv::Mat::create"],
+                  ["ParseClass", 5_000_000, 500_000, "std::vector"])
+      write_trace(File.join(object_dir, "point-rb.cpp.json"), 2_000_000,
+                  ["InstantiateClass", 100_000, 1_500_000, "Rice::Data_Type<cv::Point>"])
+
+      report = RubyBindgen::TraceReport.new(File.join(dir, "build"), File.join(dir, "ruby-bindgen-manifest.json"))
+
+      assert_equal ["core/mat-rb.cpp", "point-rb.cpp"], report.files.map(&:file)
+      assert_in_delta 12.0, report.total_seconds, 0.001
+
+      types = report.types.to_h { |type| [type.name, type.seconds] }
+      assert_in_delta 2.0, types["cv::Mat_"], 0.001
+      assert_in_delta 1.0, types["cv::Mat"], 0.001
+      assert_in_delta 1.5, types["cv::Point"], 0.001
+      assert_in_delta 7.5, types[RubyBindgen::TraceReport::UNATTRIBUTED], 0.001
+
+      assert_includes report.to_s, "cv::Mat_ (1 file)"
+      assert_equal "core/mat-rb.cpp", report.to_h(1)[:files].first[:file]
+    end
+  end
+
+  private
+
+  def write_trace(path, total, *events)
+    trace_events = [{ "ph" => "X", "tid" => 1, "ts" => 0, "dur" => total, "name" => "ExecuteCompiler" },
+                    { "ph" => "X", "tid" => 1, "ts" => 0, "dur" => total, "name" => "Total ExecuteCompiler" }]
+    events.each do |name, ts, dur, detail|
+      trace_events << { "ph" => "X", "tid" => 1, "ts" => ts, "dur" => dur, "name" => name, "args" => { "detail" => detail } }
+    end
+    File.write(path, JSON.generate("traceEvents" => trace_events))
+  end
+end